@@ -0,0 +1,52 @@
+#include "Arena.h"
+#include <new>
+
+namespace seq {
+	Arena::Arena(std::size_t bytes)
+		:buffer(static_cast<std::byte*>(::operator new(bytes))), size(bytes), owning(true) {}
+
+	Arena::Arena(void* buffer, std::size_t bytes)noexcept
+		:buffer(static_cast<std::byte*>(buffer)), size(bytes), owning(false) {}
+
+	Arena::~Arena()noexcept {
+		if (owning)
+			::operator delete(buffer);
+	}
+
+	void Arena::reset()noexcept {
+		offset = 0;
+		lastOffset = 0;
+	}
+
+	std::size_t Arena::used()const noexcept {
+		return offset;
+	}
+	std::size_t Arena::capacity()const noexcept {
+		return size;
+	}
+	std::size_t Arena::remaining()const noexcept {
+		return size - offset;
+	}
+
+	void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+		const std::size_t address = reinterpret_cast<std::size_t>(buffer) + offset;
+		const std::size_t padding = (alignment - (address % alignment)) % alignment;
+
+		if (padding > remaining() || bytes > remaining() - padding)
+			throw std::bad_alloc();
+
+		lastOffset = offset + padding;
+		offset = lastOffset + bytes;
+		return buffer + lastOffset;
+	}
+
+	void Arena::do_deallocate(void* p, std::size_t bytes, std::size_t) {
+		//only the top block can be given back, anything else waits for reset()
+		if (static_cast<std::byte*>(p) == buffer + lastOffset && lastOffset + bytes == offset)
+			offset = lastOffset;
+	}
+
+	bool Arena::do_is_equal(const std::pmr::memory_resource& other)const noexcept {
+		return this == &other;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace seq {
+	//bump pointer memory source. allocation is a pointer bump, deallocation is a no op unless the block is the most recent one
+	//(then it is handed back, so short lived containers that die in reverse order give their memory straight back).
+	//everything is released at once with reset() or when the arena dies. also usable as a std::pmr::memory_resource
+	class Arena : public std::pmr::memory_resource {
+	public:
+		explicit Arena(std::size_t bytes);
+		Arena(void* buffer, std::size_t bytes)noexcept;//borrowed buffer, not freed by the arena
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+		~Arena()noexcept;
+
+		void reset()noexcept;
+
+		std::size_t used()const noexcept;
+		std::size_t capacity()const noexcept;
+		std::size_t remaining()const noexcept;
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment)override;
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)override;
+		bool do_is_equal(const std::pmr::memory_resource& other)const noexcept override;
+
+		std::byte* buffer = nullptr;
+		std::size_t size = 0;
+		std::size_t offset = 0;
+		std::size_t lastOffset = 0;//start of the most recent block, for the pop-the-top deallocation
+		bool owning = false;
+	};
+
+	//std::allocator_traits compatible handle to an Arena, copies share the same arena
+	template <typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap            = std::true_type;
+
+		constexpr ArenaAllocator(Arena& arena)noexcept :source(&arena) {}
+		template <typename U>
+		constexpr ArenaAllocator(const ArenaAllocator<U>& rhs)noexcept :source(rhs.arena()) {}
+
+		T* allocate(std::size_t count) {
+			return static_cast<T*>(source->allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* p, std::size_t count)noexcept {
+			source->deallocate(p, count * sizeof(T), alignof(T));
+		}
+		constexpr Arena* arena()const noexcept { return source; }
+
+	private:
+		Arena* source = nullptr;
+	};
+
+	template <typename T, typename U>
+	constexpr bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)noexcept {
+		return lhs.arena() == rhs.arena();
+	}
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <unistd.h>
+#endif
+
+namespace seq::bench {
+	namespace {
+		std::string escapeJson(const std::string& text) {
+			std::string escaped;
+			for (char c : text) {
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+		std::string quoteCsv(const std::string& text) {//variants like "Sequence<int, Arena>" carry commas
+			return '"' + text + '"';
+		}
+	}
+
+	Result& Result::counter(std::string counterName, double value) {
+		counters.push_back(Counter{ std::move(counterName), value });
+		return *this;
+	}
+
+	Stats summarize(Sequence<double> samples) {
+		Stats stats;
+		stats.reps = samples.size();
+		if (samples.isEmpty())
+			return stats;
+
+		std::sort(samples.begin(), samples.end());
+		const std::size_t count = samples.size();
+		stats.min = samples.front();
+		stats.median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+		stats.p99 = samples[std::min(count - 1, static_cast<std::size_t>(std::ceil(0.99 * count)) - 1)];//nearest rank
+
+		double sum = 0.0;
+		for (double sample : samples)
+			sum += sample;
+		stats.mean = sum / count;
+
+		double squares = 0.0;
+		for (double sample : samples)
+			squares += (sample - stats.mean) * (sample - stats.mean);
+		stats.stddev = count > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+		return stats;
+	}
+
+	std::size_t residentBytes() {
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.WorkingSetSize;
+		return 0;
+#elif defined(__linux__)
+		std::ifstream statm("/proc/self/statm");
+		std::size_t pages = 0;
+		std::size_t resident = 0;
+		statm >> pages >> resident;
+		return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+		return 0;
+#endif
+	}
+
+	Runner::Runner(Config config) :config(std::move(config)) {}
+
+	const Sequence<Result>& Runner::results()const noexcept {
+		return collected;
+	}
+
+	bool Runner::wants(const std::string& name, const std::string& variant)const {
+		return config.filter.empty() || (name + "/" + variant).find(config.filter) != std::string::npos;
+	}
+
+	Result& Runner::record(std::string name, std::string variant, std::size_t n, Stats stats) {
+		Result result;
+		result.name = std::move(name);
+		result.variant = std::move(variant);
+		result.n = n;
+		result.stats = stats;
+		collected.push_back(std::move(result));
+		return collected.back();
+	}
+
+	void Runner::report(std::ostream& out)const {
+		switch (config.format) {
+		case Format::csv:
+			out << "name,variant,n,reps,min_ns,median_ns,p99_ns,mean_ns,stddev_ns,counters\n";
+			for (const Result& r : collected) {
+				out << r.name << ',' << quoteCsv(r.variant) << ',' << r.n << ',' << r.stats.reps << ','
+					<< r.stats.min << ',' << r.stats.median << ',' << r.stats.p99 << ',' << r.stats.mean << ',' << r.stats.stddev << ",\"";
+				for (std::size_t i = 0; i < r.counters.size(); i++)
+					out << (i ? ";" : "") << r.counters[i].name << '=' << r.counters[i].value;
+				out << "\"\n";
+			}
+			break;
+
+		case Format::json:
+			out << "[\n";
+			for (std::size_t i = 0; i < collected.size(); i++) {
+				const Result& r = collected[i];
+				out << "  {\"name\": \"" << escapeJson(r.name) << "\", \"variant\": \"" << escapeJson(r.variant) << "\", \"n\": " << r.n
+					<< ", \"reps\": " << r.stats.reps << ", \"min_ns\": " << r.stats.min << ", \"median_ns\": " << r.stats.median
+					<< ", \"p99_ns\": " << r.stats.p99 << ", \"mean_ns\": " << r.stats.mean << ", \"stddev_ns\": " << r.stats.stddev
+					<< ", \"counters\": {";
+				for (std::size_t c = 0; c < r.counters.size(); c++)
+					out << (c ? ", " : "") << '"' << escapeJson(r.counters[c].name) << "\": " << r.counters[c].value;
+				out << "}}" << (i + 1 < collected.size() ? "," : "") << '\n';
+			}
+			out << "]\n";
+			break;
+
+		case Format::text:
+			out << std::left << std::setw(22) << "name" << std::setw(44) << "variant" << std::right << std::setw(10) << "n"
+				<< std::setw(14) << "min us" << std::setw(14) << "median us" << std::setw(14) << "p99 us" << std::setw(12) << "stddev us" << '\n';
+			out << std::fixed << std::setprecision(1);
+			for (const Result& r : collected) {
+				out << std::left << std::setw(22) << r.name << std::setw(44) << r.variant << std::right << std::setw(10) << r.n
+					<< std::setw(14) << r.stats.min / 1000.0 << std::setw(14) << r.stats.median / 1000.0 << std::setw(14) << r.stats.p99 / 1000.0
+					<< std::setw(12) << r.stats.stddev / 1000.0;
+				for (const Counter& c : r.counters) {
+					out << "  " << c.name << '=';
+					if (c.value == std::floor(c.value))
+						out << static_cast<long long>(c.value);//counts and byte totals, no decimals to show
+					else
+						out << std::setprecision(3) << c.value << std::setprecision(1);
+				}
+				out << '\n';
+			}
+			out.unsetf(std::ios::floatfield);
+			break;
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Sequence.h"
+#include "Stopwatch.h"
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+namespace seq::bench {
+	enum class Format { text, csv, json };
+
+	struct Config {
+		std::size_t warmup = 2;//untimed runs before sampling, fills caches and the allocator
+		std::size_t reps = 15;
+		std::string filter;    //only cases whose "name/variant" contains this
+		Format format = Format::text;
+	};
+
+	struct Stats {//nanoseconds per repetition
+		double min = 0.0;
+		double median = 0.0;
+		double p99 = 0.0;
+		double mean = 0.0;
+		double stddev = 0.0;
+		std::size_t reps = 0;
+	};
+
+	struct Counter {
+		std::string name;
+		double value = 0.0;
+	};
+
+	struct Result {
+		std::string name;   //the operation, "push_back"
+		std::string variant;//what ran it, "Sequence<int>"
+		std::size_t n = 0;  //problem size
+		Stats stats;
+		Sequence<Counter> counters;//anything non-timing worth keeping next to the numbers (reallocations, bytes...)
+
+		Result& counter(std::string counterName, double value);
+	};
+
+	Stats summarize(Sequence<double> samples);
+	std::size_t residentBytes();//current resident set of the process, 0 where the platform can't tell
+
+	//keeps the optimizer from deleting work whose result nobody reads
+	template <typename T>
+	inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	class Runner {
+	public:
+		explicit Runner(Config config);
+
+		//setup() builds fresh state untimed before every repetition, body(state) is what gets timed
+		template <typename Setup, typename Body>
+		Result& measure(std::string name, std::string variant, std::size_t n, Setup setup, Body body) {
+			if (!wants(name, variant))
+				return discarded;
+
+			for (std::size_t i = 0; i < config.warmup; i++) {
+				auto state = setup();
+				body(state);
+				doNotOptimize(state);
+			}
+			Sequence<double> samples;
+			samples.reserve(config.reps);
+			for (std::size_t i = 0; i < config.reps; i++) {
+				auto state = setup();
+				Stopwatch clock;
+				body(state);
+				doNotOptimize(state);
+				samples.push_back(double(clock.MarkNanoSec().count()));
+			}
+			return record(std::move(name), std::move(variant), n, summarize(std::move(samples)));
+		}
+		//no per repetition state needed
+		template <typename Body>
+		Result& measure(std::string name, std::string variant, std::size_t n, Body body) {
+			return measure(std::move(name), std::move(variant), n, [] { return 0; }, [&body](int&) { body(); });
+		}
+
+		bool wants(const std::string& name, const std::string& variant)const;//passes the filter, lets expensive fixtures be skipped too
+		const Sequence<Result>& results()const noexcept;
+		void report(std::ostream& out)const;
+
+	private:
+		Result& record(std::string name, std::string variant, std::size_t n, Stats stats);
+
+		Config config;
+		Sequence<Result> collected;
+		Result discarded;
+	};
+}
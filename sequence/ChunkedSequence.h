@@ -0,0 +1,393 @@
+#pragma once
+
+#include "Sequence.h"
+#include <bit>
+#include <cstddef>
+
+namespace seq {
+	//deque: fixed size blocks hung off a map (a Sequence of block pointers). push/pop at both ends are O(1) amortized,
+	//only the map of pointers ever reallocates so references to elements stay valid through any push_front/push_back.
+	//iterators are (map, position) pairs and are invalidated by pushes like std::deque's; references are not.
+	//BlockBytes is rounded so a block holds a power of two elements, position -> (block, offset) is a shift and a mask.
+	//blocks are freed as soon as they empty, so a long running FIFO holds about size() elements worth of memory
+	template <typename T, typename Allocator = std::allocator<T>, std::size_t BlockBytes = 4096>
+	class ChunkedSequence {
+	private:
+		static_assert(std::is_object_v<T>, "T must be an object type");
+		static_assert(std::destructible<T>, "T must be destructible");
+		static_assert(!std::is_const_v<T>, "T cannot be const type");
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>, "Allocator::value_type must be T");
+		//forward declares
+		template <bool Const> class BasicIterator;
+
+		static constexpr std::size_t first_index = 0;
+	public:
+		//type names
+		using type            = ChunkedSequence<T, Allocator, BlockBytes>;
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = BasicIterator<false>;
+		using const_iterator  = BasicIterator<true>;
+
+		static constexpr size_type block_size = std::bit_floor(std::max<size_type>(1, BlockBytes / sizeof(T)));
+		//#################################################
+
+	private:
+		using alloc_traits    = std::allocator_traits<allocator_type>;
+		using map_type        = Sequence<pointer, typename alloc_traits::template rebind_alloc<pointer>>;
+
+		static constexpr size_type block_shift = std::countr_zero(block_size);
+		static constexpr size_type block_mask = block_size - 1;
+		static constexpr size_type min_map = 4;
+
+		//the important shit
+		template <typename... Args>
+		void constructAt(size_type pos, Args&&... args) {//pos is a map position, its block is allocated here if missing
+			pointer& block = map[pos >> block_shift];
+			const bool fresh = !block;
+			if (fresh)
+				block = memAlloc();
+			try {
+				std::construct_at(block + (pos & block_mask), std::forward<Args>(args)...);
+			}
+			catch (...) {
+				if (fresh) {
+					memDealloc(block);
+					block = nullptr;
+				}
+				throw;
+			}
+		}
+		void roomAtBack() {//makes sure the map has a slot for the block holding position start + mSize
+			const size_type node = (start + mSize) >> block_shift;
+			if (node < map.size())
+				return;
+			const size_type firstNode = start >> block_shift;
+			if (firstNode >= map.size() / 2 && firstNode > 0) {//a FIFO drifts toward the back, slide the blocks down instead of growing
+				std::rotate(map.begin(), map.begin() + firstNode, map.end());
+				start -= firstNode << block_shift;
+			}
+			else {
+				map.resize_grow(std::max(map.size() * 2, min_map));
+				if (mSize == 0)
+					recenter();
+			}
+		}
+		void roomAtFront() {//makes sure position start - 1 exists
+			if (start > 0)
+				return;
+			const size_type usedEnd = (start + mSize + block_mask) >> block_shift;
+			const size_type backFree = map.size() - usedEnd;
+			const size_type shift = backFree > map.size() / 2 ? (backFree + 1) / 2 : 0;
+			if (shift > 0) {
+				std::rotate(map.begin(), map.end() - shift, map.end());
+			}
+			else {
+				const size_type extra = std::max(map.size(), min_map);
+				map.insert(map.begin(), extra, nullptr);
+				start += extra << block_shift;
+				return;
+			}
+			start += shift << block_shift;
+		}
+		void releaseBlock(size_type node)noexcept {//the caller knows it's empty
+			memDealloc(map[node]);
+			map[node] = nullptr;
+		}
+		//#################################################
+
+		//the convenience
+		pointer memAlloc() {
+			return std::to_address(alloc_traits::allocate(alloc, block_size));
+		}
+		void memDealloc(pointer block)noexcept {
+			if (block)
+				alloc_traits::deallocate(alloc, block, block_size);
+		}
+		void objDestroyAll()noexcept {
+			if constexpr (!std::is_trivially_destructible_v<value_type>) {
+				for (size_type i = 0; i < mSize; i++)
+					std::destroy_at(slot(start + i));
+			}
+			mSize = 0;
+		}
+		void memFree()noexcept {
+			for (pointer& block : map) {
+				memDealloc(block);
+				block = nullptr;
+			}
+		}
+		void recenter()noexcept {//empty again, the next pushes may go either way
+			start = (map.size() / 2) << block_shift;
+		}
+		pointer slot(size_type pos)const noexcept {
+			return map[pos >> block_shift] + (pos & block_mask);
+		}
+		void stealFrom(ChunkedSequence& rhs)noexcept {//caller emptied *this and made the allocators compatible
+			map = std::move(rhs.map);//the map follows its own POCMA, the blocks it points at are ours from here on
+			start = std::exchange(rhs.start, 0);
+			mSize = std::exchange(rhs.mSize, 0);
+		}
+		void swapAll(ChunkedSequence& rhs) {//storage AND allocators, only for temporaries we built ourselves
+			using std::swap;
+			swap(alloc, rhs.alloc);
+			swap(map, rhs.map);//by moves, the maps' allocators may neither propagate nor compare equal
+			swap(start, rhs.start);
+			swap(mSize, rhs.mSize);
+		}
+		void swapStorage(ChunkedSequence& rhs)noexcept {//allocators equal
+			using std::swap;
+			map.swap(rhs.map);
+			swap(start, rhs.start);
+			swap(mSize, rhs.mSize);
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		ChunkedSequence()noexcept(std::is_nothrow_default_constructible_v<allocator_type>) requires std::default_initializable<allocator_type> = default;
+		explicit ChunkedSequence(const allocator_type& allocator) :alloc(allocator), map(typename map_type::allocator_type(allocator)) {}
+		ChunkedSequence(size_type count, const_reference value, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type>
+			:ChunkedSequence(allocator) {
+			for (size_type i = 0; i < count; i++)
+				push_back(value);
+		}
+		ChunkedSequence(std::initializer_list<value_type> init, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type>
+			:ChunkedSequence(allocator) {
+			for (const_reference value : init)
+				push_back(value);
+		}
+		ChunkedSequence(const ChunkedSequence& rhs, const allocator_type& allocator) requires std::copyable<value_type>
+			:ChunkedSequence(allocator) {
+			for (const_reference value : rhs)
+				push_back(value);
+		}
+		ChunkedSequence(const ChunkedSequence& rhs) requires std::copyable<value_type>
+			:ChunkedSequence(rhs, alloc_traits::select_on_container_copy_construction(rhs.alloc)) {}
+		ChunkedSequence(ChunkedSequence&& rhs)noexcept
+			:alloc(std::move(rhs.alloc)), map(std::move(rhs.map)), start(std::exchange(rhs.start, 0)), mSize(std::exchange(rhs.mSize, 0)) {}
+		ChunkedSequence(ChunkedSequence&& rhs, const allocator_type& allocator) :ChunkedSequence(allocator) {
+			if (alloc == rhs.alloc) {
+				stealFrom(rhs);
+			}
+			else {//blocks from another memory source, the elements move over one by one
+				for (reference value : rhs)
+					push_back(std::move(value));
+			}
+		}
+		ChunkedSequence& operator=(const ChunkedSequence& rhs) requires std::copyable<value_type> {
+			if (this == &rhs)
+				return *this;
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				ChunkedSequence temp(rhs, rhs.alloc);
+				swapAll(temp);
+			}
+			else {
+				ChunkedSequence temp(rhs, alloc);
+				swapStorage(temp);
+			}
+			return *this;
+		}
+		ChunkedSequence& operator=(ChunkedSequence&& rhs)noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+			if (this == &rhs)
+				return *this;
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+				objDestroyAll();
+				memFree();//with the allocator that made the blocks, before it is replaced
+				if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+					alloc = std::move(rhs.alloc);
+				stealFrom(rhs);
+			}
+			else if (alloc == rhs.alloc) {
+				objDestroyAll();
+				memFree();
+				stealFrom(rhs);
+			}
+			else {
+				ChunkedSequence temp(std::move(rhs), alloc);
+				swapStorage(temp);
+			}
+			return *this;
+		}
+		~ChunkedSequence()noexcept {
+			objDestroyAll();
+			memFree();
+		}
+		//#################################################
+
+		//ACCESS
+		reference front() {
+			assert(mSize > first_index);
+			return *slot(start);
+		}
+		const_reference front()const {
+			assert(mSize > first_index);
+			return *slot(start);
+		}
+		reference back() {
+			assert(mSize > first_index);
+			return *slot(start + mSize - 1);
+		}
+		const_reference back()const {
+			assert(mSize > first_index);
+			return *slot(start + mSize - 1);
+		}
+		reference operator[](size_type index) {
+			assert(index < mSize);
+			return *slot(start + index);
+		}
+		const_reference operator[](size_type index)const {
+			assert(index < mSize);
+			return *slot(start + index);
+		}
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return *slot(start + pos);
+		}
+		const_reference at(size_type pos)const {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return *slot(start + pos);
+		}
+
+		iterator       begin()                  { return { map.data(), start }; }
+		iterator       end()                    { return { map.data(), start + mSize }; }
+		const_iterator begin()const             { return { map.data(), start }; }
+		const_iterator end()const               { return { map.data(), start + mSize }; }
+		const_iterator cbegin()const            { return { map.data(), start }; }
+		const_iterator cend()const              { return { map.data(), start + mSize }; }
+		//#################################################
+
+		//MODIFICATION
+		template <typename U>
+		void push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {
+			emplace_back(std::forward<U>(value));
+		}
+		template <typename... Args>
+		void emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			roomAtBack();
+			constructAt(start + mSize, std::forward<Args>(args)...);
+			++mSize;
+		}
+		template <typename U>
+		void push_front(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {
+			emplace_front(std::forward<U>(value));
+		}
+		template <typename... Args>
+		void emplace_front(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			roomAtFront();
+			constructAt(start - 1, std::forward<Args>(args)...);
+			--start;
+			++mSize;
+		}
+		void pop_back()noexcept {
+			if (mSize == 0)
+				return;
+			--mSize;
+			const size_type pos = start + mSize;
+			std::destroy_at(slot(pos));
+			if ((pos & block_mask) == 0 || mSize == 0)//took the last element out of its block
+				releaseBlock(pos >> block_shift);
+			if (mSize == 0)
+				recenter();
+		}
+		void pop_front()noexcept {
+			if (mSize == 0)
+				return;
+			const size_type pos = start;
+			std::destroy_at(slot(pos));
+			++start;
+			--mSize;
+			if ((start & block_mask) == 0 || mSize == 0)
+				releaseBlock(pos >> block_shift);
+			if (mSize == 0)
+				recenter();
+		}
+		void clear()noexcept {//keeps the map, frees every block
+			objDestroyAll();
+			memFree();
+			recenter();
+		}
+		void swap(ChunkedSequence& rhs)noexcept {
+			using std::swap;
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+				swap(alloc, rhs.alloc);
+			else
+				assert(alloc == rhs.alloc && "swapping ChunkedSequences with unequal non-propagating allocators is undefined");
+			map.swap(rhs.map);
+			swap(start, rhs.start);
+			swap(mSize, rhs.mSize);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept  { return mSize == 0; }
+		size_type size()const noexcept     { return mSize; }
+		size_type blockCount()const noexcept {
+			return mSize == 0 ? 0 : ((start + mSize - 1) >> block_shift) - (start >> block_shift) + 1;
+		}
+		allocator_type get_allocator()const noexcept { return alloc; }
+		//#################################################
+	private:
+		//members
+		SEQ_NO_UNIQUE_ADDRESS allocator_type alloc;
+		map_type map;
+		size_type start = 0;//map position of the front element
+		size_type mSize = 0;
+	};
+
+	//(map, position) pair, same arithmetic and comparisons as Sequence's Iterator. one extra load per dereference for the block
+	template <typename T, typename Allocator, std::size_t BlockBytes>
+	template <bool Const>
+	class ChunkedSequence<T, Allocator, BlockBytes>::BasicIterator {
+		using node_type = std::conditional_t<Const, const T* const, T* const>;
+	public:
+		using value_type = T;
+		using element_type = std::conditional_t<Const, const T, T>;
+		using pointer = element_type*;
+		using reference = element_type&;
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using self_type = BasicIterator;
+
+		constexpr reference operator*()const noexcept { return nodes[pos >> block_shift][pos & block_mask]; }
+		constexpr pointer operator->()const noexcept { return nodes[pos >> block_shift] + (pos & block_mask); }
+		constexpr reference operator[](difference_type n)const noexcept { return *(*this + n); }
+
+		constexpr self_type& operator++()noexcept { ++pos; return *this; }
+		constexpr self_type operator++(int)noexcept { self_type temp = *this; ++pos; return temp; }
+		constexpr self_type& operator--()noexcept { --pos; return *this; }
+		constexpr self_type operator--(int)noexcept { self_type temp = *this; --pos; return temp; }
+
+		constexpr self_type& operator+=(difference_type n)noexcept { pos += n; return *this; }
+		constexpr self_type& operator-=(difference_type n)noexcept { pos -= n; return *this; }
+		constexpr self_type operator+(difference_type n)const noexcept { return self_type(nodes, pos + n); }
+		constexpr self_type operator-(difference_type n)const noexcept { return self_type(nodes, pos - n); }
+		constexpr difference_type operator-(const self_type& rhs)const noexcept { return difference_type(pos - rhs.pos); }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
+
+		constexpr bool operator==(const self_type& rhs)const noexcept { return pos == rhs.pos; }
+		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return pos <=> rhs.pos; }
+
+		constexpr BasicIterator()noexcept = default;
+		constexpr BasicIterator(node_type* nodes, size_type pos)noexcept :nodes(nodes), pos(pos) {}
+		template <bool OtherConst> requires (Const && !OtherConst)
+		constexpr BasicIterator(const BasicIterator<OtherConst>& rhs)noexcept :nodes(rhs.nodes), pos(rhs.pos) {}
+	private:
+		friend class BasicIterator<true>;
+		node_type* nodes = nullptr;
+		size_type pos = 0;
+	};
+
+	template <typename T, typename Allocator, std::size_t BlockBytes>
+	void swap(ChunkedSequence<T, Allocator, BlockBytes>& lhs, ChunkedSequence<T, Allocator, BlockBytes>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "Sequence.h"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <thread>
+
+namespace seq {
+	//append only Sequence for many producer threads. storage is a fixed table of segments that double in size
+	//(32, 64, 128, ...), a segment is never moved once published, so growth doesn't invalidate anything and
+	//push_back is one fetch_add plus, for the thread that opens a new segment, one allocation and one CAS.
+	//every slot carries a ready flag: operator[] is valid for an index once its push_back returned (or was otherwise
+	//observed ready), snapshot() copies whatever is published into a plain contiguous Sequence while producers keep going.
+	//a segment that can't be allocated is marked dead: every push landing in it throws bad_alloc and its slots read as failed
+	//holes until clear(), so readers never wait on an index nobody will fill
+	template <typename T>
+	class ConcurrentSequence {
+	private:
+		static_assert(std::is_object_v<T>, "T must be an object type");
+		static_assert(std::destructible<T>, "T must be destructible");
+		static_assert(!std::is_const_v<T>, "T cannot be const type");
+
+		enum SlotState : unsigned char { empty = 0, ready = 1, failed = 2 };//failed: the constructor threw, the slot stays a hole
+
+		static constexpr std::size_t first_segment_log = 5;
+		static constexpr std::size_t first_segment = std::size_t(1) << first_segment_log;
+		static constexpr std::size_t segment_count = sizeof(std::size_t) * 8 - first_segment_log;
+	public:
+		//type names
+		using type            = ConcurrentSequence<T>;
+		using value_type      = T;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		//#################################################
+
+	private:
+		struct Location {
+			size_type segment;
+			size_type offset;
+		};
+		static constexpr size_type segmentSize(size_type segment)noexcept {
+			return first_segment << segment;
+		}
+		static constexpr Location locate(size_type index)noexcept {//segment k covers [32 * (2^k - 1), 32 * (2^(k+1) - 1))
+			const size_type shifted = index + first_segment;
+			const size_type segment = std::bit_width(shifted) - 1 - first_segment_log;
+			return { segment, shifted - segmentSize(segment) };
+		}
+		//a segment block is [T x n][state x n], the states trail the elements so T keeps its natural alignment
+		static constexpr size_type blockBytes(size_type segment)noexcept {
+			return segmentSize(segment) * (sizeof(value_type) + sizeof(std::atomic<unsigned char>));
+		}
+		static pointer items(std::byte* block)noexcept {
+			return reinterpret_cast<pointer>(block);
+		}
+		static std::atomic<unsigned char>* states(std::byte* block, size_type segment)noexcept {
+			return reinterpret_cast<std::atomic<unsigned char>*>(block + segmentSize(segment) * sizeof(value_type));
+		}
+
+		static std::byte* deadSegment()noexcept {//marks a segment whose allocation failed, every slot in it reads as failed
+			static std::byte mark;
+			return &mark;
+		}
+
+		//the important shit
+		std::byte* trySegment(size_type segment) {//returns the segment, allocating it if this thread got there first
+			std::byte* block = segments[segment].load(std::memory_order_acquire);
+			if (block == deadSegment())
+				throw std::bad_alloc();
+			if (block)
+				return block;
+
+			std::byte* fresh = static_cast<std::byte*>(::operator new(blockBytes(segment), std::align_val_t(alignof(value_type)), std::nothrow));
+			if (!fresh) {//the index is already claimed, so the segment is published dead instead of left open for the readers to wait on
+				if (segments[segment].compare_exchange_strong(block, deadSegment(), std::memory_order_acq_rel, std::memory_order_acquire)
+					|| block == deadSegment())
+					throw std::bad_alloc();
+				return block;//someone else managed to allocate it meanwhile
+			}
+			std::atomic<unsigned char>* flags = states(fresh, segment);
+			for (size_type i = 0; i < segmentSize(segment); i++)
+				std::construct_at(flags + i, empty);
+
+			if (segments[segment].compare_exchange_strong(block, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+				return fresh;
+			::operator delete(fresh, std::align_val_t(alignof(value_type)));//lost the race, block holds the winner
+			if (block == deadSegment())
+				throw std::bad_alloc();
+			return block;
+		}
+		template <typename... Args>
+		size_type tryEmplace(Args&&... args) {
+			const size_type index = claimed.fetch_add(1, std::memory_order_relaxed);
+			const Location at = locate(index);
+			std::byte* block = trySegment(at.segment);//a throw here leaves the segment dead, stateOf reports the slot failed
+			try {
+				std::construct_at(items(block) + at.offset, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				states(block, at.segment)[at.offset].store(failed, std::memory_order_release);
+				throw;
+			}
+			states(block, at.segment)[at.offset].store(ready, std::memory_order_release);
+			return index;
+		}
+		//#################################################
+
+		//the convenience
+		unsigned char stateOf(size_type index)const noexcept {
+			const Location at = locate(index);
+			std::byte* block = segments[at.segment].load(std::memory_order_acquire);
+			if (block == deadSegment())
+				return failed;
+			return block ? states(block, at.segment)[at.offset].load(std::memory_order_acquire) : static_cast<unsigned char>(empty);
+		}
+		unsigned char waitState(size_type index)const noexcept {//claimed slots are always settled shortly, spin until then
+			unsigned char state = stateOf(index);
+			while (state == empty) {
+				std::this_thread::yield();
+				state = stateOf(index);
+			}
+			return state;
+		}
+		pointer slot(size_type index)const noexcept {
+			const Location at = locate(index);
+			return items(segments[at.segment].load(std::memory_order_acquire)) + at.offset;
+		}
+		template <typename Visit>
+		void forEachSettled(size_type count, Visit visit)const {//every claimed slot below count, in order, failed ones skipped
+			for (size_type i = 0; i < count; i++) {
+				if (waitState(i) == ready)
+					visit(*slot(i));
+			}
+		}
+		void objDestroyAll()noexcept {
+			const size_type count = claimed.load(std::memory_order_acquire);
+			for (size_type i = 0; i < count; i++) {
+				if (stateOf(i) == ready)
+					std::destroy_at(slot(i));
+			}
+			claimed.store(0, std::memory_order_relaxed);
+		}
+		void memFree()noexcept {
+			for (size_type s = 0; s < segment_count; s++) {
+				std::byte* block = segments[s].exchange(nullptr, std::memory_order_acq_rel);
+				if (block && block != deadSegment())
+					::operator delete(block, std::align_val_t(alignof(value_type)));
+			}
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		ConcurrentSequence()noexcept = default;
+		ConcurrentSequence(const ConcurrentSequence&) = delete;
+		ConcurrentSequence& operator=(const ConcurrentSequence&) = delete;
+		~ConcurrentSequence()noexcept {
+			objDestroyAll();
+			memFree();
+		}
+		//#################################################
+
+		//ACCESS, safe alongside pushes as long as the index is published
+		reference operator[](size_type index)noexcept {
+			assert(index < size() && stateOf(index) == ready);
+			return *slot(index);
+		}
+		const_reference operator[](size_type index)const noexcept {
+			assert(index < size() && stateOf(index) == ready);
+			return *slot(index);
+		}
+		reference at(size_type pos) {
+			if (pos >= size() || stateOf(pos) != ready)
+				throw std::out_of_range("position out of range or not published");
+			return *slot(pos);
+		}
+		const_reference at(size_type pos)const {
+			if (pos >= size() || stateOf(pos) != ready)
+				throw std::out_of_range("position out of range or not published");
+			return *slot(pos);
+		}
+		bool isReady(size_type index)const noexcept {
+			return index < size() && stateOf(index) == ready;
+		}
+		//#################################################
+
+		//MODIFICATION, push_back/emplace_back are the only members safe to call from many threads at once
+		template <typename U>
+		size_type push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {
+			return tryEmplace(std::forward<U>(value));
+		}
+		template <typename... Args>
+		size_type emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			return tryEmplace(std::forward<Args>(args)...);
+		}
+		Sequence<value_type> snapshot()const requires std::copyable<value_type> {//concurrent safe copy of everything claimed so far
+			const size_type count = size();
+			Sequence<value_type> result;
+			result.reserve(count);
+			forEachSettled(count, [&result](const_reference value) { result.push_back(value); });
+			return result;
+		}
+		Sequence<value_type> flatten() requires strong_movable<value_type> {//NOT concurrent: moves everything out and leaves this empty
+			const size_type count = size();
+			Sequence<value_type> result;
+			result.reserve(count);
+			forEachSettled(count, [&result](reference value) { result.push_back(std::move(value)); });
+			clear();
+			return result;
+		}
+		void clear()noexcept {//NOT concurrent, keeps the segments for reuse
+			objDestroyAll();
+			for (size_type s = 0; s < segment_count; s++) {
+				std::byte* block = segments[s].load(std::memory_order_relaxed);
+				if (block == deadSegment())
+					segments[s].store(nullptr, std::memory_order_relaxed);//gets another chance to allocate
+				if (!block || block == deadSegment())
+					continue;//segments can open out of order, a hole here says nothing about later ones
+				std::atomic<unsigned char>* flags = states(block, s);
+				for (size_type i = 0; i < segmentSize(s); i++)
+					flags[i].store(empty, std::memory_order_relaxed);
+			}
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept { return size() == 0; }
+		size_type size()const noexcept    { return claimed.load(std::memory_order_acquire); }//claimed, not necessarily published yet
+		//#################################################
+	private:
+		//members
+		std::atomic<std::byte*> segments[segment_count] = {};
+		std::atomic<size_type> claimed = 0;
+	};
+}
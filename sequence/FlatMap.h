@@ -0,0 +1,319 @@
+#pragma once
+
+#include "FlatSet.h"
+#include <span>
+#include <stdexcept>
+
+namespace seq {
+	//sorted unique keys with their values in a second, parallel Sequence: a search walks the key array only, so the values
+	//never dilute the cache lines the search touches, and values() is a plain span for loops that ignore the keys.
+	//same cost model as FlatSet: build from a batch, add batches with insert_range, single inserts/erases shift both arrays.
+	//element access hands out pairs of references, iterators and references die with any modification
+	template <typename Key, typename T, typename Compare = std::less<Key>, typename Search = BinarySearch,
+		typename KeyAllocator = std::allocator<Key>, typename MappedAllocator = std::allocator<T>>
+	class FlatMap {
+	private:
+		static_assert(std::is_same_v<typename std::allocator_traits<KeyAllocator>::value_type, Key>, "KeyAllocator::value_type must be Key");
+		static_assert(std::is_same_v<typename std::allocator_traits<MappedAllocator>::value_type, T>, "MappedAllocator::value_type must be T");
+		static_assert(std::is_same_v<Search, BinarySearch> || std::is_same_v<Search, EytzingerSearch>, "Search must be BinarySearch or EytzingerSearch");
+
+		template <bool Const> class BasicIterator;
+	public:
+		//type names
+		using type                  = FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>;
+		using key_type              = Key;
+		using mapped_type           = T;
+		using value_type            = std::pair<Key, T>;
+		using key_compare           = Compare;
+		using search_type           = Search;
+		using reference             = std::pair<const Key&, T&>;
+		using const_reference       = std::pair<const Key&, const T&>;
+		using size_type             = std::size_t;
+		using difference_type       = std::ptrdiff_t;
+		using key_container_type    = Sequence<Key, KeyAllocator>;
+		using mapped_container_type = Sequence<T, MappedAllocator>;
+
+		using iterator              = BasicIterator<false>;
+		using const_iterator        = BasicIterator<true>;
+		//#################################################
+
+	private:
+		//the important shit
+		size_type lowerIndex(const key_type& key)const {
+			return index.lowerBound(sortedKeys.data(), sortedKeys.size(), key, comp);
+		}
+		bool matches(size_type pos, const key_type& key)const {
+			return pos < sortedKeys.size() && !comp(key, sortedKeys[pos]);
+		}
+		template <typename K, typename... Args>
+		std::pair<iterator, bool> emplaceKey(K&& key, Args&&... args) {
+			const size_type pos = lowerIndex(key);
+			if (matches(pos, key))
+				return { iterator(this, pos), false };
+			mapped_type value(std::forward<Args>(args)...);
+			detail::insertAt(sortedKeys, pos, std::forward<K>(key));
+			try {
+				detail::insertAt(mapped, pos, std::move(value));
+			}
+			catch (...) {
+				sortedKeys.erase(sortedKeys.begin() + pos);
+				throw;
+			}
+			index.rebuild(sortedKeys.data(), sortedKeys.size());
+			return { iterator(this, pos), true };
+		}
+		//unsorted, maybe repeating, parallel arrays. a permutation is sorted instead of the pairs, then one merge pass moves
+		//everything into fresh arrays. keys already present win, then the first of a repeat, like inserting them one by one
+		void mergeIn(key_container_type& keys, mapped_container_type& values) {
+			assert(keys.size() == values.size());
+			Sequence<size_type> order;
+			order.reserve(keys.size());
+			for (size_type i = 0; i < keys.size(); i++)
+				order.push_back(i);
+			std::stable_sort(order.begin(), order.end(), [&](size_type lhs, size_type rhs) { return comp(keys[lhs], keys[rhs]); });
+			order.erase(std::unique(order.begin(), order.end(), [&](size_type lhs, size_type rhs) { return !comp(keys[lhs], keys[rhs]); }), order.end());
+
+			key_container_type mergedKeys(sortedKeys.get_allocator());
+			mapped_container_type mergedValues(mapped.get_allocator());
+			mergedKeys.reserve(sortedKeys.size() + keys.size());
+			mergedValues.reserve(sortedKeys.size() + keys.size());
+			auto take = [&](key_type& key, mapped_type& value) {
+				mergedKeys.push_back(std::move(key));
+				mergedValues.push_back(std::move(value));
+			};
+			size_type have = 0;
+			for (size_type add : order) {
+				key_type& key = keys[add];
+				while (have < sortedKeys.size() && comp(sortedKeys[have], key)) {
+					take(sortedKeys[have], mapped[have]);
+					++have;
+				}
+				if (have < sortedKeys.size() && !comp(key, sortedKeys[have]))
+					continue;//already mapped
+				take(key, values[add]);
+			}
+			for (; have < sortedKeys.size(); ++have)
+				take(sortedKeys[have], mapped[have]);
+
+			sortedKeys.swap(mergedKeys);
+			mapped.swap(mergedValues);
+			index.rebuild(sortedKeys.data(), sortedKeys.size());
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		FlatMap() = default;
+		explicit FlatMap(const key_compare& compare, const KeyAllocator& keyAllocator = KeyAllocator(), const MappedAllocator& mappedAllocator = MappedAllocator())
+			:sortedKeys(keyAllocator), mapped(mappedAllocator), comp(compare), index(keyAllocator) {}
+		template <std::ranges::input_range Range>
+		explicit FlatMap(Range&& unsorted, const key_compare& compare = key_compare()) :FlatMap(compare) {
+			insert_range(std::forward<Range>(unsorted));
+		}
+		FlatMap(std::initializer_list<value_type> init, const key_compare& compare = key_compare()) :FlatMap(compare) {
+			insert_range(init);
+		}
+		//bulk build straight from parallel arrays, keys[i] maps to values[i]
+		FlatMap(key_container_type keys, mapped_container_type values, const key_compare& compare = key_compare())
+			:FlatMap(compare, keys.get_allocator(), values.get_allocator()) {
+			if (keys.size() != values.size())
+				throw std::invalid_argument("FlatMap: keys and values differ in length");
+			mergeIn(keys, values);
+		}
+		//#################################################
+
+		//ACCESS
+		iterator find(const key_type& key) {
+			const size_type pos = lowerIndex(key);
+			return { this, matches(pos, key) ? pos : size() };
+		}
+		const_iterator find(const key_type& key)const {
+			const size_type pos = lowerIndex(key);
+			return { this, matches(pos, key) ? pos : size() };
+		}
+		bool contains(const key_type& key)const {
+			return matches(lowerIndex(key), key);
+		}
+		size_type count(const key_type& key)const {
+			return contains(key);
+		}
+		mapped_type& at(const key_type& key) {
+			const size_type pos = lowerIndex(key);
+			if (!matches(pos, key))
+				throw std::out_of_range("key not found");
+			return mapped[pos];
+		}
+		const mapped_type& at(const key_type& key)const {
+			const size_type pos = lowerIndex(key);
+			if (!matches(pos, key))
+				throw std::out_of_range("key not found");
+			return mapped[pos];
+		}
+		mapped_type& operator[](const key_type& key) requires std::default_initializable<mapped_type> {
+			return (*try_emplace(key).first).second;
+		}
+		mapped_type& operator[](key_type&& key) requires std::default_initializable<mapped_type> {
+			return (*try_emplace(std::move(key)).first).second;
+		}
+		iterator       lower_bound(const key_type& key)       { return { this, lowerIndex(key) }; }
+		const_iterator lower_bound(const key_type& key)const  { return { this, lowerIndex(key) }; }
+		iterator upper_bound(const key_type& key) {
+			const size_type pos = lowerIndex(key);
+			return { this, pos + matches(pos, key) };
+		}
+		const_iterator upper_bound(const key_type& key)const {
+			const size_type pos = lowerIndex(key);
+			return { this, pos + matches(pos, key) };
+		}
+		const key_container_type& keys()const noexcept      { return sortedKeys; }
+		std::span<mapped_type> values()noexcept             { return { mapped.data(), mapped.size() }; }
+		std::span<const mapped_type> values()const noexcept { return { mapped.data(), mapped.size() }; }
+		key_compare key_comp()const { return comp; }
+
+		iterator       begin()                  { return { this, 0 }; }
+		iterator       end()                    { return { this, size() }; }
+		const_iterator begin()const             { return { this, 0 }; }
+		const_iterator end()const               { return { this, size() }; }
+		const_iterator cbegin()const            { return { this, 0 }; }
+		const_iterator cend()const              { return { this, size() }; }
+		//#################################################
+
+		//MODIFICATION
+		template <typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) requires std::constructible_from<mapped_type, Args&&...> {
+			return emplaceKey(key, std::forward<Args>(args)...);
+		}
+		template <typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) requires std::constructible_from<mapped_type, Args&&...> {
+			return emplaceKey(std::move(key), std::forward<Args>(args)...);
+		}
+		std::pair<iterator, bool> insert(const value_type& value) {
+			return emplaceKey(value.first, value.second);
+		}
+		std::pair<iterator, bool> insert(value_type&& value) {
+			return emplaceKey(std::move(value.first), std::move(value.second));
+		}
+		template <typename M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) requires std::assignable_from<mapped_type&, M&&> {
+			const size_type pos = lowerIndex(key);
+			if (matches(pos, key)) {
+				mapped[pos] = std::forward<M>(obj);
+				return { iterator(this, pos), false };
+			}
+			return emplaceKey(key, std::forward<M>(obj));
+		}
+		//batched: pairs are collected into parallel arrays and merged in one pass, O(n + m log m) instead of m shifting inserts
+		template <std::ranges::input_range Range>
+		void insert_range(Range&& range) {
+			key_container_type keys(sortedKeys.get_allocator());
+			mapped_container_type values(mapped.get_allocator());
+			if constexpr (std::ranges::sized_range<Range>) {
+				keys.reserve(std::ranges::size(range));
+				values.reserve(std::ranges::size(range));
+			}
+			for (auto&& elem : range) {//pair-like, moved from only when the range hands out rvalues
+				keys.push_back(std::get<0>(std::forward<decltype(elem)>(elem)));
+				values.push_back(std::get<1>(std::forward<decltype(elem)>(elem)));
+			}
+			mergeIn(keys, values);
+		}
+		size_type erase(const key_type& key) {
+			const size_type pos = lowerIndex(key);
+			if (!matches(pos, key))
+				return 0;
+			erase(const_iterator(this, pos));
+			return 1;
+		}
+		iterator erase(const_iterator pos) {
+			const size_type at = pos.index();
+			sortedKeys.erase(sortedKeys.begin() + at);
+			mapped.erase(mapped.begin() + at);
+			index.rebuild(sortedKeys.data(), sortedKeys.size());
+			return { this, at };
+		}
+		void clear()noexcept {
+			sortedKeys.clear();
+			mapped.clear();
+			index.clear();
+		}
+		void swap(FlatMap& rhs)noexcept {
+			using std::swap;
+			sortedKeys.swap(rhs.sortedKeys);
+			mapped.swap(rhs.mapped);
+			swap(comp, rhs.comp);
+			swap(index, rhs.index);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept { return sortedKeys.isEmpty(); }
+		size_type size()const noexcept    { return sortedKeys.size(); }
+		void reserve(size_type newCap) {
+			sortedKeys.reserve(newCap);
+			mapped.reserve(newCap);
+		}
+		void shrinkToFit() {
+			sortedKeys.shrinkToFit();
+			mapped.shrinkToFit();
+		}
+		//#################################################
+	private:
+		//members
+		key_container_type sortedKeys;
+		mapped_container_type mapped;
+		SEQ_NO_UNIQUE_ADDRESS key_compare comp;
+		SEQ_NO_UNIQUE_ADDRESS detail::SearchIndex<search_type, key_type, KeyAllocator> index;
+	};
+
+	//(map, position) pair like SoASequence's, dereferences to a pair of references into the two arrays
+	template <typename Key, typename T, typename Compare, typename Search, typename KeyAllocator, typename MappedAllocator>
+	template <bool Const>
+	class FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>::BasicIterator {
+		using owner_type = std::conditional_t<Const, const FlatMap, FlatMap>;
+	public:
+		using value_type = std::pair<Key, T>;
+		using reference = std::conditional_t<Const, std::pair<const Key&, const T&>, std::pair<const Key&, T&>>;
+		using pointer = void;
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using self_type = BasicIterator;
+
+		constexpr reference operator*()const noexcept { return { owner->sortedKeys[pos], owner->mapped[pos] }; }
+		constexpr reference operator[](difference_type n)const noexcept { return *(*this + n); }
+		constexpr const Key& key()const noexcept { return owner->sortedKeys[pos]; }
+		constexpr std::conditional_t<Const, const T&, T&> value()const noexcept { return owner->mapped[pos]; }
+
+		constexpr self_type& operator++()noexcept { ++pos; return *this; }
+		constexpr self_type operator++(int)noexcept { self_type temp = *this; ++pos; return temp; }
+		constexpr self_type& operator--()noexcept { --pos; return *this; }
+		constexpr self_type operator--(int)noexcept { self_type temp = *this; --pos; return temp; }
+
+		constexpr self_type& operator+=(difference_type n)noexcept { pos += n; return *this; }
+		constexpr self_type& operator-=(difference_type n)noexcept { pos -= n; return *this; }
+		constexpr self_type operator+(difference_type n)const noexcept { return self_type(owner, pos + n); }
+		constexpr self_type operator-(difference_type n)const noexcept { return self_type(owner, pos - n); }
+		constexpr difference_type operator-(const self_type& rhs)const noexcept { return difference_type(pos) - difference_type(rhs.pos); }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
+
+		constexpr bool operator==(const self_type& rhs)const noexcept { return pos == rhs.pos; }
+		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return pos <=> rhs.pos; }
+
+		constexpr BasicIterator()noexcept = default;
+		constexpr BasicIterator(owner_type* owner, size_type pos)noexcept :owner(owner), pos(pos) {}
+		template <bool OtherConst> requires (Const && !OtherConst)
+		constexpr BasicIterator(const BasicIterator<OtherConst>& rhs)noexcept :owner(rhs.owner), pos(rhs.pos) {}
+		constexpr size_type index()const noexcept { return pos; }
+	private:
+		friend class BasicIterator<true>;
+		owner_type* owner = nullptr;
+		size_type pos = 0;
+	};
+
+	template <typename Key, typename T, typename Compare, typename Search, typename KeyAllocator, typename MappedAllocator>
+	bool operator==(const FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>& lhs, const FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>& rhs) {
+		return lhs.keys() == rhs.keys() && std::ranges::equal(lhs.values(), rhs.values());
+	}
+	template <typename Key, typename T, typename Compare, typename Search, typename KeyAllocator, typename MappedAllocator>
+	void swap(FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>& lhs, FlatMap<Key, T, Compare, Search, KeyAllocator, MappedAllocator>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "Sequence.h"
+#include <bit>
+#include <functional>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace seq {
+	//search layouts for FlatSet/FlatMap. BinarySearch searches the sorted keys in place, branch free, nothing extra stored.
+	//EytzingerSearch keeps a second copy of the keys in breadth first order (node k's children at 2k and 2k+1): the first
+	//levels of every search share a few cache lines and the next levels can be prefetched, which pays off once the keys
+	//outgrow the cache. costs a copy of the keys, rebuilt on every modification
+	struct BinarySearch {};
+	struct EytzingerSearch {};
+
+	namespace detail {
+		inline void prefetch(const void* p)noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#endif
+		}
+
+		template <typename Search, typename Key, typename Allocator>
+		class SearchIndex;
+
+		template <typename Key, typename Allocator>
+		class SearchIndex<BinarySearch, Key, Allocator> {
+		public:
+			SearchIndex() = default;
+			explicit SearchIndex(const Allocator&)noexcept {}
+
+			void rebuild(const Key*, std::size_t)noexcept {}
+			void clear()noexcept {}
+			//first position whose key is not less than key. the halving is a conditional move, not a branch the predictor has to guess
+			template <typename Compare>
+			std::size_t lowerBound(const Key* keys, std::size_t count, const Key& key, const Compare& comp)const {
+				if (count == 0)
+					return 0;
+				const Key* base = keys;
+				while (count > 1) {
+					const std::size_t half = count / 2;
+					base = comp(base[half], key) ? base + half : base;
+					count -= half;
+				}
+				return std::size_t(base - keys) + comp(*base, key);
+			}
+		};
+
+		template <typename Key, typename Allocator>
+		class SearchIndex<EytzingerSearch, Key, Allocator> {
+			static_assert(std::copyable<Key>, "EytzingerSearch keeps a copy of the keys, Key must be copyable");
+
+			using size_type = std::size_t;
+			//descendants of node k four levels down (for 4 byte keys) are one cache line starting at node k * stride
+			static constexpr size_type stride = std::max<size_type>(2, std::bit_floor(64 / sizeof(Key)));
+		public:
+			SearchIndex() = default;
+			explicit SearchIndex(const Allocator& allocator) :tree(allocator) {}
+
+			//the keys have already changed when this runs. a tree that can't be built (allocation, a throwing copy) is dropped
+			//instead of left stale, and lookups search the keys themselves until the next rebuild succeeds
+			void rebuild(const Key* sorted, size_type count)noexcept {
+				try {
+					tree.clear();
+					tree.reserve(count);
+					for (size_type k = 1; k <= count; k++)
+						tree.push_back(sorted[rankOf(k, count)]);
+				}
+				catch (...) {
+					tree.clear();
+				}
+			}
+			void clear()noexcept {
+				tree.clear();
+			}
+			template <typename Compare>
+			size_type lowerBound(const Key* keys, size_type count, const Key& key, const Compare& comp)const {
+				if (tree.size() != count)//dropped by a failed rebuild
+					return SearchIndex<BinarySearch, Key, Allocator>().lowerBound(keys, count, key, comp);
+				const Key* nodes = tree.data();//node k lives at k - 1, the arithmetic below needs the root at 1
+				size_type k = 1;
+				while (k <= count) {
+					if (k * stride <= count)
+						prefetch(nodes + k * stride - 1);
+					k = 2 * k + comp(nodes[k - 1], key);
+				}
+				k >>= std::countr_one(k) + 1;//undo the right turns taken after the last left one, that left turn's node is the answer
+				return k == 0 ? count : rankOf(k, count);
+			}
+		private:
+			//sorted position of node k, no table needed: in a perfect tree it falls out of k's depth and offset, and a partial
+			//last level (filled from the left) only removes the even positions past its last node
+			static size_type rankOf(size_type k, size_type count)noexcept {
+				const unsigned levels = unsigned(std::bit_width(count));
+				const unsigned depth = unsigned(std::bit_width(k)) - 1;
+				const size_type perfect = ((2 * (k - (size_type(1) << depth)) + 1) << (levels - 1 - depth)) - 1;
+				const size_type lastLevel = count - ((size_type(1) << (levels - 1)) - 1);
+				return perfect < 2 * lastLevel ? perfect : perfect - (perfect - 2 * lastLevel + 1) / 2;
+			}
+
+			Sequence<Key, Allocator> tree;
+		};
+
+		//one element into the middle: append then rotate into place, works for move only types and reallocates at most once
+		template <typename Seq, typename V>
+		void insertAt(Seq& seq, std::size_t index, V&& value) {
+			seq.emplace_back(std::forward<V>(value));
+			std::rotate(seq.begin() + index, seq.end() - 1, seq.end());
+		}
+	}
+
+	//sorted unique keys in one Sequence. lookups are O(log n) over contiguous memory, iteration is in key order.
+	//single insert/erase shift the tail like any array, so build from a batch (one sort, one dedup) and add with insert_range
+	//(sort the batch, one merge pass) instead of inserting one by one. iterators and references die with any modification
+	template <typename Key, typename Compare = std::less<Key>, typename Search = BinarySearch, typename Allocator = std::allocator<Key>>
+	class FlatSet {
+	private:
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, Key>, "Allocator::value_type must be Key");
+		static_assert(std::is_same_v<Search, BinarySearch> || std::is_same_v<Search, EytzingerSearch>, "Search must be BinarySearch or EytzingerSearch");
+	public:
+		//type names
+		using type            = FlatSet<Key, Compare, Search, Allocator>;
+		using key_type        = Key;
+		using value_type      = Key;
+		using key_compare     = Compare;
+		using value_compare   = Compare;
+		using search_type     = Search;
+		using allocator_type  = Allocator;
+		using container_type  = Sequence<Key, Allocator>;
+		using reference       = const Key&;
+		using const_reference = const Key&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = typename container_type::const_iterator;//keys are never writable, it would break the order
+		using const_iterator  = typename container_type::const_iterator;
+		//#################################################
+
+	private:
+		//the important shit
+		size_type lowerIndex(const key_type& key)const {
+			return index.lowerBound(sorted.data(), sorted.size(), key, comp);
+		}
+		bool matches(size_type pos, const key_type& key)const {
+			return pos < sorted.size() && !comp(key, sorted[pos]);
+		}
+		void mergeIn(container_type& incoming) {//unsorted, maybe repeating. keys already present win, then the first of a repeat
+			std::sort(incoming.begin(), incoming.end(), comp);
+			incoming.erase(std::unique(incoming.begin(), incoming.end(), [this](const key_type& lhs, const key_type& rhs) { return !comp(lhs, rhs); }), incoming.end());
+			if (sorted.isEmpty()) {
+				sorted.swap(incoming);
+			}
+			else {
+				container_type merged(sorted.get_allocator());
+				merged.reserve(sorted.size() + incoming.size());
+				auto have = sorted.begin();
+				auto add = incoming.begin();
+				while (have != sorted.end() && add != incoming.end()) {
+					if (comp(*add, *have)) {
+						merged.push_back(std::move(*add++));
+					}
+					else {
+						if (!comp(*have, *add))
+							++add;
+						merged.push_back(std::move(*have++));
+					}
+				}
+				for (; have != sorted.end(); ++have)
+					merged.push_back(std::move(*have));
+				for (; add != incoming.end(); ++add)
+					merged.push_back(std::move(*add));
+				sorted.swap(merged);
+			}
+			index.rebuild(sorted.data(), sorted.size());
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		FlatSet() = default;
+		explicit FlatSet(const key_compare& compare, const allocator_type& allocator = allocator_type())
+			:sorted(allocator), comp(compare), index(allocator) {}
+		template <std::ranges::input_range Range>
+		explicit FlatSet(Range&& unsorted, const key_compare& compare = key_compare(), const allocator_type& allocator = allocator_type())
+			requires std::constructible_from<key_type, std::ranges::range_reference_t<Range>> :FlatSet(compare, allocator) {
+			insert_range(std::forward<Range>(unsorted));
+		}
+		FlatSet(std::initializer_list<key_type> init, const key_compare& compare = key_compare(), const allocator_type& allocator = allocator_type())
+			:FlatSet(compare, allocator) {
+			insert_range(init);
+		}
+		//#################################################
+
+		//ACCESS
+		const_iterator find(const key_type& key)const {
+			const size_type pos = lowerIndex(key);
+			return matches(pos, key) ? sorted.begin() + pos : sorted.end();
+		}
+		bool contains(const key_type& key)const {
+			return matches(lowerIndex(key), key);
+		}
+		size_type count(const key_type& key)const {
+			return contains(key);
+		}
+		const_iterator lower_bound(const key_type& key)const {
+			return sorted.begin() + lowerIndex(key);
+		}
+		const_iterator upper_bound(const key_type& key)const {
+			const size_type pos = lowerIndex(key);
+			return sorted.begin() + pos + matches(pos, key);
+		}
+		const container_type& keys()const noexcept { return sorted; }
+		key_compare key_comp()const { return comp; }
+
+		const_iterator begin()const               { return sorted.begin(); }
+		const_iterator end()const                 { return sorted.end(); }
+		const_iterator cbegin()const              { return sorted.cbegin(); }
+		const_iterator cend()const                { return sorted.cend(); }
+		//#################################################
+
+		//MODIFICATION
+		std::pair<const_iterator, bool> insert(const key_type& key) {
+			return emplace(key);
+		}
+		std::pair<const_iterator, bool> insert(key_type&& key) {
+			return emplace(std::move(key));
+		}
+		template <typename... Args>
+		std::pair<const_iterator, bool> emplace(Args&&... args) requires std::constructible_from<key_type, Args&&...> {
+			key_type key(std::forward<Args>(args)...);
+			const size_type pos = lowerIndex(key);
+			if (matches(pos, key))
+				return { sorted.begin() + pos, false };
+			detail::insertAt(sorted, pos, std::move(key));
+			index.rebuild(sorted.data(), sorted.size());
+			return { sorted.begin() + pos, true };
+		}
+		//batched: the range is collected, sorted and merged in one pass, O(n + m log m) instead of m shifting inserts
+		template <std::ranges::input_range Range>
+		void insert_range(Range&& range) requires std::constructible_from<key_type, std::ranges::range_reference_t<Range>> {
+			container_type incoming(sorted.get_allocator());
+			incoming.append_range(std::forward<Range>(range));
+			mergeIn(incoming);
+		}
+		size_type erase(const key_type& key) {
+			const size_type pos = lowerIndex(key);
+			if (!matches(pos, key))
+				return 0;
+			sorted.erase(sorted.begin() + pos);
+			index.rebuild(sorted.data(), sorted.size());
+			return 1;
+		}
+		const_iterator erase(const_iterator pos) {
+			const size_type at = pos - sorted.cbegin();
+			sorted.erase(sorted.begin() + at);
+			index.rebuild(sorted.data(), sorted.size());
+			return sorted.begin() + at;
+		}
+		void clear()noexcept {
+			sorted.clear();
+			index.clear();
+		}
+		void swap(FlatSet& rhs)noexcept {
+			using std::swap;
+			sorted.swap(rhs.sorted);
+			swap(comp, rhs.comp);
+			swap(index, rhs.index);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept { return sorted.isEmpty(); }
+		size_type size()const noexcept    { return sorted.size(); }
+		void reserve(size_type newCap) {
+			sorted.reserve(newCap);
+		}
+		void shrinkToFit() {
+			sorted.shrinkToFit();
+		}
+		//#################################################
+	private:
+		//members
+		container_type sorted;
+		SEQ_NO_UNIQUE_ADDRESS key_compare comp;
+		SEQ_NO_UNIQUE_ADDRESS detail::SearchIndex<search_type, key_type, allocator_type> index;
+	};
+
+	template <typename Key, typename Compare, typename Search, typename Allocator>
+	bool operator==(const FlatSet<Key, Compare, Search, Allocator>& lhs, const FlatSet<Key, Compare, Search, Allocator>& rhs) {
+		return lhs.keys() == rhs.keys();
+	}
+	template <typename Key, typename Compare, typename Search, typename Allocator>
+	void swap(FlatSet<Key, Compare, Search, Allocator>& lhs, FlatSet<Key, Compare, Search, Allocator>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+
+//msvc accepts the standard spelling but silently ignores it
+#if defined(_MSC_VER)
+#define SEQ_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define SEQ_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace seq {
+	//growth policies decide the new capacity when a Sequence runs out of room.
+	//next(cap, required) must return at least required. growth is relative to the current capacity, not the request,
+	//so resize_grow(1'000'000) on an empty Sequence allocates 1'000'000 and not 1'500'001.
+	//onReallocate is a hook for Tracked<>, plain policies leave it empty and cost nothing
+
+	//1.5x, the classic Sequence curve 1 -> 2 -> 4 -> 7 -> 11
+	struct GrowGeometric {
+		static constexpr bool use_usable_size = false;
+		constexpr std::size_t next(std::size_t cap, std::size_t required)const noexcept {
+			return std::max(required, cap + (cap / 2) + 1);
+		}
+		constexpr void onReallocate(std::size_t, std::size_t, std::size_t)noexcept {}
+	};
+
+	//2x, fewer reallocations for more slack
+	struct GrowDouble {
+		static constexpr bool use_usable_size = false;
+		constexpr std::size_t next(std::size_t cap, std::size_t required)const noexcept {
+			return std::max(required, cap > 0 ? cap * 2 : 1);
+		}
+		constexpr void onReallocate(std::size_t, std::size_t, std::size_t)noexcept {}
+	};
+
+	//exactly what is asked for. zero slack, but push_back loops become quadratic, meant for build once containers
+	struct GrowExact {
+		static constexpr bool use_usable_size = false;
+		constexpr std::size_t next(std::size_t, std::size_t required)const noexcept {
+			return required;
+		}
+		constexpr void onReallocate(std::size_t, std::size_t, std::size_t)noexcept {}
+	};
+
+	//1.5x, then the capacity is rounded up to whatever the allocator actually handed out (see MallocAllocator::usable_size).
+	//malloc rounds every request to a size class anyway, this just stops the tail of that block from going unused
+	struct GrowSizeClass : GrowGeometric {
+		static constexpr bool use_usable_size = true;
+	};
+
+	//wraps any policy and keeps score, so policies can be compared on a real workload
+	template <typename Policy>
+	struct Tracked : Policy {
+		std::size_t reallocations = 0;
+		std::size_t bytesAllocated = 0;
+		std::size_t bytesWasted = 0;//capacity handed out beyond what the operation needed
+		std::size_t peakWasted = 0;//biggest single over-allocation
+
+		constexpr void onReallocate(std::size_t required, std::size_t granted, std::size_t elemSize)noexcept {
+			const std::size_t waste = (granted - required) * elemSize;
+			++reallocations;
+			bytesAllocated += granted * elemSize;
+			bytesWasted += waste;
+			peakWasted = std::max(peakWasted, waste);
+		}
+	};
+}
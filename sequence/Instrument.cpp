@@ -0,0 +1,110 @@
+#include "Instrument.h"
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#if defined(__GNUG__)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+namespace seq::stats {
+	namespace {
+		struct Entry {
+			std::string name;
+			Counters counters;
+		};
+		struct Registry {
+			std::mutex lock;
+			std::deque<Entry> entries;//deque, so handed out references survive later registrations
+		};
+		Registry& registry() {//function local, Sequences with static storage may register before main
+			static Registry instance;
+			return instance;
+		}
+
+		Snapshot copyOf(const Entry& entry) {
+			const Counters& c = entry.counters;
+			Snapshot shot;
+			shot.name = entry.name;
+			shot.allocations = c.allocations.load(std::memory_order_relaxed);
+			shot.deallocations = c.deallocations.load(std::memory_order_relaxed);
+			shot.reallocations = c.reallocations.load(std::memory_order_relaxed);
+			shot.bytesAllocated = c.bytesAllocated.load(std::memory_order_relaxed);
+			shot.bytesMoved = c.bytesMoved.load(std::memory_order_relaxed);
+			shot.constructions = c.constructions.load(std::memory_order_relaxed);
+			shot.destructions = c.destructions.load(std::memory_order_relaxed);
+			shot.peakCapacity = c.peakCapacity.load(std::memory_order_relaxed);
+			shot.peakWasted = c.peakWasted.load(std::memory_order_relaxed);
+			shot.wastedAtRelease = c.wastedAtRelease.load(std::memory_order_relaxed);
+			shot.reallocNanos = c.reallocNanos.load(std::memory_order_relaxed);
+			return shot;
+		}
+	}
+
+	Counters& counters(std::string_view name) {
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		for (Entry& entry : reg.entries) {
+			if (entry.name == name)
+				return entry.counters;
+		}
+		return reg.entries.emplace_back(std::string(name)).counters;
+	}
+
+	std::string readableName(const std::type_info& info) {
+#if defined(__GNUG__)
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(info.name(), nullptr, nullptr, &status);
+		if (status == 0 && demangled) {
+			std::string name(demangled);
+			std::free(demangled);
+			return name;
+		}
+#endif
+		return info.name();//msvc names are readable already
+	}
+
+	Snapshot read(std::string_view name) {
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		for (const Entry& entry : reg.entries) {
+			if (entry.name == name)
+				return copyOf(entry);
+		}
+		Snapshot none;
+		none.name = name;
+		return none;
+	}
+
+	void report(std::ostream& out) {
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		if (reg.entries.empty()) {
+			out << "no Sequence stats recorded (build with SEQ_STATS)\n";
+			return;
+		}
+		for (const Entry& entry : reg.entries) {
+			const Snapshot s = copyOf(entry);
+			out << s.name << '\n'
+				<< "  allocations " << s.allocations << ", deallocations " << s.deallocations << ", reallocations " << s.reallocations
+				<< ", realloc time " << std::fixed << std::setprecision(3) << s.reallocNanos / 1e6 << " ms\n"
+				<< "  bytes allocated " << s.bytesAllocated << ", bytes moved " << s.bytesMoved << '\n'
+				<< "  constructions " << s.constructions << ", destructions " << s.destructions << '\n'
+				<< "  peak capacity " << s.peakCapacity << " B, peak wasted " << s.peakWasted << " B, wasted at release " << s.wastedAtRelease << " B\n";
+			out.unsetf(std::ios::floatfield);
+		}
+	}
+
+	void reset() {
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> guard(reg.lock);
+		for (Entry& entry : reg.entries) {
+			Counters& c = entry.counters;
+			for (std::atomic<std::size_t>* field : { &c.allocations, &c.deallocations, &c.reallocations, &c.bytesAllocated, &c.bytesMoved,
+				&c.constructions, &c.destructions, &c.peakCapacity, &c.peakWasted, &c.wastedAtRelease })
+				field->store(0, std::memory_order_relaxed);
+			c.reallocNanos.store(0, std::memory_order_relaxed);
+		}
+	}
+}
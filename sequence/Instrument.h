@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#ifdef SEQ_STATS
+#include "Stopwatch.h"
+#endif
+
+//stats build mode. define SEQ_STATS for the whole project and every Sequence reports into a global registry,
+//one entry per Sequence<T, Allocator, Growth> instantiation unless an instance is tagged into its own.
+//without it, BasicSink below is an empty class of empty inline functions and Sequence doesn't grow by a byte
+namespace seq::stats {
+	struct Counters {//shared by every instance reporting to it, possibly on many threads, so relaxed atomics
+		std::atomic<std::size_t> allocations = 0;
+		std::atomic<std::size_t> deallocations = 0;
+		std::atomic<std::size_t> reallocations = 0;  //growth or shrink that moved the elements (or realloc'd them)
+		std::atomic<std::size_t> bytesAllocated = 0;
+		std::atomic<std::size_t> bytesMoved = 0;     //element bytes carried over by reallocations
+		std::atomic<std::size_t> constructions = 0;  //elements that entered a Sequence, moves during growth excluded
+		std::atomic<std::size_t> destructions = 0;   //elements that left one
+		std::atomic<std::size_t> peakCapacity = 0;   //bytes, largest single block any instance held
+		std::atomic<std::size_t> peakWasted = 0;     //bytes, largest unused tail right after a reallocation
+		std::atomic<std::size_t> wastedAtRelease = 0;//bytes, summed unused tails of blocks when they were given back
+		std::atomic<long long> reallocNanos = 0;
+	};
+
+	struct Snapshot {//plain copy of one entry
+		std::string name;
+		std::size_t allocations = 0;
+		std::size_t deallocations = 0;
+		std::size_t reallocations = 0;
+		std::size_t bytesAllocated = 0;
+		std::size_t bytesMoved = 0;
+		std::size_t constructions = 0;
+		std::size_t destructions = 0;
+		std::size_t peakCapacity = 0;
+		std::size_t peakWasted = 0;
+		std::size_t wastedAtRelease = 0;
+		long long reallocNanos = 0;
+	};
+
+	//find or create, entries live until the program ends so the reference can be cached
+	Counters& counters(std::string_view name);
+	std::string readableName(const std::type_info& info);//demangled where the platform mangles
+	Snapshot read(std::string_view name);//zeros when there is no such entry
+	void report(std::ostream& out);//every entry, in registration order
+	void reset();//zeros all counters, entries stay
+
+	template <typename Owner>
+	Counters& forType() {
+		static Counters& entry = counters(readableName(typeid(Owner)));
+		return entry;
+	}
+
+	namespace detail {
+		inline void raiseTo(std::atomic<std::size_t>& peak, std::size_t value)noexcept {
+			std::size_t seen = peak.load(std::memory_order_relaxed);
+			while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+		}
+	}
+
+#ifdef SEQ_STATS
+	class ReallocTimer {//times one reallocation with Stopwatch, charged on scope exit
+	public:
+		explicit ReallocTimer(Counters& target)noexcept :target(target) {}
+		ReallocTimer(const ReallocTimer&) = delete;
+		~ReallocTimer() {
+			target.reallocNanos.fetch_add(clock.MarkNanoSec().count(), std::memory_order_relaxed);
+		}
+	private:
+		Counters& target;
+		Stopwatch clock;
+	};
+
+	//what a Sequence holds: a pointer to the entry it reports to
+	template <typename Owner>
+	class BasicSink {
+	public:
+		BasicSink()noexcept :target(&forType<Owner>()) {}
+		BasicSink(const BasicSink&)noexcept :BasicSink() {}//tags belong to the instance, a copy or move reports to the type again
+		BasicSink& operator=(const BasicSink&)noexcept { return *this; }
+
+		void tag(std::string_view name) { target = &counters(name); }
+
+		void allocated(std::size_t bytes)noexcept {
+			target->allocations.fetch_add(1, std::memory_order_relaxed);
+			target->bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+			detail::raiseTo(target->peakCapacity, bytes);
+		}
+		void deallocated()noexcept {
+			target->deallocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		void released(std::size_t unusedBytes)noexcept {//a block that held elements is let go, by growth or by the owner dying
+			target->wastedAtRelease.fetch_add(unusedBytes, std::memory_order_relaxed);
+		}
+		void reallocated(std::size_t movedBytes, std::size_t unusedBytes)noexcept {
+			target->reallocations.fetch_add(1, std::memory_order_relaxed);
+			target->bytesMoved.fetch_add(movedBytes, std::memory_order_relaxed);
+			detail::raiseTo(target->peakWasted, unusedBytes);
+		}
+		void constructed(std::size_t count)noexcept { target->constructions.fetch_add(count, std::memory_order_relaxed); }
+		void destroyed(std::size_t count)noexcept   { target->destructions.fetch_add(count, std::memory_order_relaxed); }
+		[[nodiscard]] ReallocTimer timeReallocation()noexcept { return ReallocTimer(*target); }
+	private:
+		Counters* target;
+	};
+#else
+	struct ReallocTimer {};
+	template <typename Owner>
+	struct BasicSink {
+		constexpr void tag(std::string_view)noexcept {}
+		constexpr void allocated(std::size_t)noexcept {}
+		constexpr void deallocated()noexcept {}
+		constexpr void released(std::size_t)noexcept {}
+		constexpr void reallocated(std::size_t, std::size_t)noexcept {}
+		constexpr void constructed(std::size_t)noexcept {}
+		constexpr void destroyed(std::size_t)noexcept {}
+		constexpr ReallocTimer timeReallocation()noexcept { return {}; }
+	};
+#endif
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define SEQ_MALLOC_USABLE_SIZE(p) _msize(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define SEQ_MALLOC_USABLE_SIZE(p) malloc_size(p)
+#else
+#include <malloc.h>
+#define SEQ_MALLOC_USABLE_SIZE(p) malloc_usable_size(p)
+#endif
+
+namespace seq {
+	//malloc/free/realloc backed allocator. on its own it's nothing special, the point is reallocate():
+	//Sequence uses it for relocatable T so growth can extend the block in place (glibc will mremap large blocks instead of copying).
+	//usable_size() reports the real size class of a block, which GrowSizeClass turns into extra capacity
+	template <typename T>
+	class MallocAllocator {
+		static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can't satisfy over-aligned types");
+	public:
+		using value_type = T;
+		using is_always_equal = std::true_type;
+
+		constexpr MallocAllocator()noexcept = default;
+		template <typename U>
+		constexpr MallocAllocator(const MallocAllocator<U>&)noexcept {}
+
+		T* allocate(std::size_t count) {
+			void* p = std::malloc(bytesFor(count));
+			if (!p)
+				throw std::bad_alloc();
+			return static_cast<T*>(p);
+		}
+		void deallocate(T* p, std::size_t)noexcept {
+			std::free(p);
+		}
+		T* reallocate(T* p, std::size_t, std::size_t newCount) {
+			void* moved = std::realloc(p, bytesFor(newCount));
+			if (!moved)
+				throw std::bad_alloc();//p is still intact
+			return static_cast<T*>(moved);
+		}
+		std::size_t usable_size(T* p)const noexcept {
+			return SEQ_MALLOC_USABLE_SIZE(p) / sizeof(T);
+		}
+
+	private:
+		static constexpr std::size_t bytesFor(std::size_t count)noexcept {
+			return count > 0 ? count * sizeof(T) : 1;//malloc(0)/realloc(p, 0) are implementation defined, never ask for 0
+		}
+	};
+
+	template <typename T, typename U>
+	constexpr bool operator==(const MallocAllocator<T>&, const MallocAllocator<U>&)noexcept {
+		return true;
+	}
+}
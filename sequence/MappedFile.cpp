@@ -0,0 +1,243 @@
+#include "MappedFile.h"
+#include <system_error>
+#include <utility>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace seq {
+	namespace {
+		[[noreturn]] void throwLastError(const char* what) {
+#if defined(_WIN32)
+			throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+#else
+			throw std::system_error(errno, std::system_category(), what);
+#endif
+		}
+	}
+
+#if defined(_WIN32)
+	MappedFile::MappedFile(const std::string& path, MapMode mode) :mode(mode) {
+		const bool writable = mode != MapMode::readOnly;
+		const DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+		const DWORD disposition = mode == MapMode::readOnly ? OPEN_EXISTING : mode == MapMode::create ? CREATE_ALWAYS : OPEN_ALWAYS;
+		HANDLE handle = ::CreateFileA(path.c_str(), access, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			throwLastError("MappedFile: open");
+		file = handle;
+
+		LARGE_INTEGER bytes;
+		if (!::GetFileSizeEx(handle, &bytes)) {
+			close();
+			throwLastError("MappedFile: size");
+		}
+		length = static_cast<std::size_t>(bytes.QuadPart);
+		try {
+			mapView();
+		}
+		catch (...) {
+			close();
+			throw;
+		}
+	}
+
+	void MappedFile::mapView() {
+		if (length == 0)
+			return;
+		const bool writable = mode != MapMode::readOnly;
+		const ULARGE_INTEGER bytes{ .QuadPart = length };
+		mapping = ::CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, bytes.HighPart, bytes.LowPart, nullptr);
+		if (!mapping)
+			throwLastError("MappedFile: CreateFileMapping");
+		view = static_cast<std::byte*>(::MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length));
+		if (!view) {
+			::CloseHandle(mapping);
+			mapping = nullptr;
+			throwLastError("MappedFile: MapViewOfFile");
+		}
+	}
+
+	void MappedFile::unmapView()noexcept {
+		if (view)
+			::UnmapViewOfFile(view);
+		if (mapping)
+			::CloseHandle(mapping);
+		view = nullptr;
+		mapping = nullptr;
+	}
+
+	void MappedFile::close()noexcept {
+		unmapView();
+		if (file)
+			::CloseHandle(file);
+		file = nullptr;
+	}
+
+	void MappedFile::resize(std::size_t bytes) {//windows can't resize a file while a view of it is open, so no in place growth here
+		const std::size_t oldLength = length;
+		auto setEnd = [this](std::size_t at) {
+			LARGE_INTEGER end{ .QuadPart = static_cast<LONGLONG>(at) };
+			return ::SetFilePointerEx(file, end, nullptr, FILE_BEGIN) && ::SetEndOfFile(file);
+		};
+		unmapView();
+		if (!setEnd(bytes)) {
+			mapView();//best effort to leave the old mapping usable
+			throwLastError("MappedFile: resize");
+		}
+		length = bytes;
+		try {
+			mapView();
+		}
+		catch (...) {//best effort back to the old length and mapping, an empty one if even that fails, never a length without a view
+			length = setEnd(oldLength) ? oldLength : 0;
+			try {
+				mapView();
+			}
+			catch (...) {
+				length = 0;
+			}
+			throw;
+		}
+	}
+
+	void MappedFile::flush() {
+		if (view && (!::FlushViewOfFile(view, 0) || !::FlushFileBuffers(file)))
+			throwLastError("MappedFile: flush");
+	}
+
+	void MappedFile::adviseSequential()noexcept {}
+#else
+	MappedFile::MappedFile(const std::string& path, MapMode mode) :mode(mode) {
+		const int flags = mode == MapMode::readOnly ? O_RDONLY : mode == MapMode::create ? (O_RDWR | O_CREAT | O_TRUNC) : (O_RDWR | O_CREAT);
+		fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+		if (fd < 0)
+			throwLastError("MappedFile: open");
+
+		struct stat info;
+		if (::fstat(fd, &info) != 0) {
+			const int error = errno;
+			close();
+			throw std::system_error(error, std::system_category(), "MappedFile: fstat");
+		}
+		length = static_cast<std::size_t>(info.st_size);
+		try {
+			mapView();
+		}
+		catch (...) {
+			close();
+			throw;
+		}
+	}
+
+	void MappedFile::mapView() {
+		if (length == 0)
+			return;
+		const int protection = mode == MapMode::readOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+		void* p = ::mmap(nullptr, length, protection, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED)
+			throwLastError("MappedFile: mmap");
+		view = static_cast<std::byte*>(p);
+	}
+
+	void MappedFile::unmapView()noexcept {
+		if (view)
+			::munmap(view, length);
+		view = nullptr;
+	}
+
+	void MappedFile::close()noexcept {
+		unmapView();
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+	}
+
+	void MappedFile::resize(std::size_t bytes) {//the file grows before the mapping and shrinks after it, no page is ever mapped past its end
+		const std::size_t oldLength = length;
+		if (bytes > oldLength && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+			throwLastError("MappedFile: ftruncate");
+		try {
+			remapView(bytes);
+		}
+		catch (...) {
+			if (bytes > oldLength) {
+				[[maybe_unused]] const int undone = ::ftruncate(fd, static_cast<off_t>(oldLength));//best effort, the old mapping fits either way
+			}
+			throw;
+		}
+		if (bytes < oldLength && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+			throwLastError("MappedFile: ftruncate");//the mapping already shrank, the file only keeps a tail nothing maps
+	}
+
+	void MappedFile::remapView(std::size_t bytes) {//on a throw the old view and length stay as they were
+#if defined(__linux__)
+		if (view && bytes > 0) {//the kernel moves the page tables, nothing is copied
+			void* p = ::mremap(view, length, bytes, MREMAP_MAYMOVE);
+			if (p == MAP_FAILED)
+				throwLastError("MappedFile: mremap");
+			view = static_cast<std::byte*>(p);
+			length = bytes;
+			return;
+		}
+#endif
+		std::byte* oldView = std::exchange(view, nullptr);
+		const std::size_t oldLength = std::exchange(length, bytes);
+		try {
+			mapView();
+		}
+		catch (...) {
+			view = oldView;
+			length = oldLength;
+			throw;
+		}
+		if (oldView)
+			::munmap(oldView, oldLength);
+	}
+
+	void MappedFile::flush() {
+		if (view && ::msync(view, length, MS_SYNC) != 0)
+			throwLastError("MappedFile: msync");
+	}
+
+	void MappedFile::adviseSequential()noexcept {
+		if (view)
+			::madvise(view, length, MADV_SEQUENTIAL);
+	}
+#endif
+
+	MappedFile::MappedFile(MappedFile&& rhs)noexcept
+		:view(std::exchange(rhs.view, nullptr)), length(std::exchange(rhs.length, 0)), mode(rhs.mode)
+#if defined(_WIN32)
+		, file(std::exchange(rhs.file, nullptr)), mapping(std::exchange(rhs.mapping, nullptr)) {}
+#else
+		, fd(std::exchange(rhs.fd, -1)) {}
+#endif
+
+	MappedFile& MappedFile::operator=(MappedFile&& rhs)noexcept {
+		if (this == &rhs)
+			return *this;
+		close();
+		view = std::exchange(rhs.view, nullptr);
+		length = std::exchange(rhs.length, 0);
+		mode = rhs.mode;
+#if defined(_WIN32)
+		file = std::exchange(rhs.file, nullptr);
+		mapping = std::exchange(rhs.mapping, nullptr);
+#else
+		fd = std::exchange(rhs.fd, -1);
+#endif
+		return *this;
+	}
+
+	MappedFile::~MappedFile()noexcept {
+		close();
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace seq {
+	enum class MapMode {
+		readOnly, //existing file, shared pages straight from the page cache, nothing is copied
+		readWrite,//existing file or a new empty one, writes land in the file
+		create    //like readWrite, but an existing file is truncated to empty first
+	};
+
+	//a whole file mapped into memory. resize() changes the file length and the mapping together
+	//(ftruncate + mremap on linux, remap elsewhere) so data() may move, like a Sequence reallocating.
+	//errors are thrown as std::system_error carrying the os error code
+	class MappedFile {
+	public:
+		MappedFile(const std::string& path, MapMode mode);
+		MappedFile(MappedFile&& rhs)noexcept;
+		MappedFile& operator=(MappedFile&& rhs)noexcept;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile()noexcept;
+
+		void resize(std::size_t bytes);//writable mappings only, new bytes read as zero
+		void flush();//blocks until dirty pages are written back (msync / FlushViewOfFile)
+		void adviseSequential()noexcept;//hint for one front to back pass, no op where unsupported
+
+		std::byte*       data()noexcept           { return view; }
+		const std::byte* data()const noexcept     { return view; }
+		std::size_t      size()const noexcept     { return length; }
+		bool             isReadOnly()const noexcept { return mode == MapMode::readOnly; }
+
+	private:
+		void mapView();
+		void unmapView()noexcept;
+#if !defined(_WIN32)
+		void remapView(std::size_t bytes);
+#endif
+		void close()noexcept;
+
+		std::byte* view = nullptr;//null while the file is empty, zero length mappings aren't allowed
+		std::size_t length = 0;
+		MapMode mode = MapMode::readOnly;
+#if defined(_WIN32)
+		void* file = nullptr;//HANDLE, kept as void* so <windows.h> stays out of the header
+		void* mapping = nullptr;
+#else
+		int fd = -1;
+#endif
+	};
+}
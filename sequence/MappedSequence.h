@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Sequence.h"
+#include "MappedFile.h"
+#include <string>
+
+namespace seq {
+	//Sequence whose element array IS a file. opening is zero copy: the pages come in on first touch straight from the page cache,
+	//so a dataset bigger than RAM costs address space, not memory. growth extends the file and the mapping together.
+	//while open the file carries the unused capacity as a zeroed tail, the destructor (or shrinkToFit) trims it back to exactly size()
+	//elements, so the file on disk is always a plain array of T. trivially copyable T only, the bytes ARE the objects.
+	//MappedSequence<const T> is the read only flavour: it maps MapMode::readOnly, hands out const T only and has no modifiers.
+	//a MappedSequence<T> opened readOnly throws std::logic_error from every modifier and asserts on non const element access,
+	//the pages are PROT_READ and a write through them would fault. read it through std::as_const, or use the const flavour
+	template <typename T, typename Growth = GrowGeometric>
+	class MappedSequence {
+	private:
+		static_assert(std::is_trivially_copyable_v<T>, "MappedSequence stores raw bytes, T must be trivially copyable");
+		static constexpr bool read_only = std::is_const_v<T>;
+
+		static constexpr std::size_t first_index = 0;
+		static constexpr std::size_t min_grow_bytes = 64 * 1024;//every growth is a syscall pair, don't do it for a handful of elements
+	public:
+		//type names
+		using type            = MappedSequence<T, Growth>;
+		using value_type      = std::remove_const_t<T>;
+		using growth_type     = Growth;
+		using pointer         = T*;
+		using const_pointer   = const value_type*;
+		using reference       = T&;
+		using const_reference = const value_type&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using const_iterator  = typename Sequence<value_type>::const_iterator;
+		using iterator        = std::conditional_t<read_only, const_iterator, typename Sequence<value_type>::iterator>;
+		//#################################################
+
+	private:
+		//the important shit
+		void tryReMap(size_type count) {//file and mapping to exactly count elements, the array may move
+			requireWritable();
+			file.resize(count * sizeof(value_type));
+		}
+		void growTo(size_type required) {
+			const size_type floor = std::max<size_type>(1, min_grow_bytes / sizeof(value_type));
+			tryReMap(std::max(growth.next(capacity(), required), floor));
+		}
+		//#################################################
+
+		//the convenience
+		void requireWritable()const {
+			if (file.isReadOnly())
+				throw std::logic_error("MappedSequence opened read only");
+		}
+		void validatePosition(const_pointer pos)const {
+			if (pos < raw_begin() || pos > raw_end()) throw std::out_of_range("position out of range");
+		}
+		value_type*   raw_begin()noexcept       { return reinterpret_cast<value_type*>(file.data()); }
+		value_type*   raw_end()noexcept         { return raw_begin() + mSize; }
+		const_pointer raw_begin()const noexcept { return reinterpret_cast<const_pointer>(file.data()); }
+		const_pointer raw_end()const noexcept   { return raw_begin() + mSize; }
+		pointer       elems()noexcept {//what the non const accessors hand out
+			assert((read_only || !file.isReadOnly()) && "writable access to a read only mapping, read through std::as_const or MappedSequence<const T>");
+			return raw_begin();
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		explicit MappedSequence(const std::string& path, MapMode mode = read_only ? MapMode::readOnly : MapMode::readWrite) :file(path, mode) {
+			if (read_only && mode != MapMode::readOnly)
+				throw std::logic_error("MappedSequence<const T> maps read only");
+			if (file.size() % sizeof(value_type) != 0)
+				throw std::runtime_error("MappedSequence: file length is not a whole number of elements");
+			mSize = file.size() / sizeof(value_type);
+		}
+		MappedSequence(MappedSequence&& rhs)noexcept :file(std::move(rhs.file)), growth(rhs.growth), mSize(std::exchange(rhs.mSize, 0)) {}
+		MappedSequence& operator=(MappedSequence&& rhs)noexcept {
+			if (this == &rhs)
+				return *this;
+			trimFile();
+			file = std::move(rhs.file);
+			growth = rhs.growth;
+			mSize = std::exchange(rhs.mSize, 0);
+			return *this;
+		}
+		MappedSequence(const MappedSequence&) = delete;
+		MappedSequence& operator=(const MappedSequence&) = delete;
+		~MappedSequence()noexcept {
+			trimFile();
+		}
+		//#################################################
+
+		//ACCESS
+		reference front() {
+			assert(mSize > first_index);
+			return elems()[first_index];
+		}
+		const_reference front()const {
+			assert(mSize > first_index);
+			return raw_begin()[first_index];
+		}
+		reference back() {
+			assert(mSize > first_index);
+			return elems()[mSize - 1];
+		}
+		const_reference back()const {
+			assert(mSize > first_index);
+			return raw_begin()[mSize - 1];
+		}
+		reference operator[](size_type index) {
+			assert(index < mSize);
+			return elems()[index];
+		}
+		const_reference operator[](size_type index)const {
+			assert(index < mSize);
+			return raw_begin()[index];
+		}
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return elems()[pos];
+		}
+		const_reference at(size_type pos)const {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return raw_begin()[pos];
+		}
+		pointer        data()noexcept           { return elems(); }
+		const_pointer  data()const noexcept     { return raw_begin(); }
+
+		iterator       begin()                  { return { elems() }; }
+		iterator       end()                    { return { elems() + mSize }; }
+		const_iterator begin()const             { return { raw_begin() }; }
+		const_iterator end()const               { return { raw_end() }; }
+		const_iterator cbegin()const            { return { raw_begin() }; }
+		const_iterator cend()const              { return { raw_end() }; }
+		//#################################################
+
+		//MODIFICATION, all of them throw std::logic_error on a read only mapping, MappedSequence<const T> has none
+		void push_back(const_reference value) requires (!read_only) {
+			requireWritable();
+			const value_type copy = value;//value may live in the mapping a remap is about to move
+			if (mSize == capacity())
+				growTo(mSize + 1);
+			std::construct_at(raw_end(), copy);
+			++mSize;
+		}
+		template<typename... Args> void emplace_back(Args&&... args) requires (!read_only) && std::constructible_from<value_type, Args&&...> {
+			requireWritable();
+			const value_type value(std::forward<Args>(args)...);//built before a remap could move anything args point into
+			if (mSize == capacity())
+				growTo(mSize + 1);
+			std::construct_at(raw_end(), value);
+			++mSize;
+		}
+		template <std::ranges::forward_range Range>
+		void append_range(Range&& range) requires (!read_only) && std::constructible_from<value_type, std::ranges::range_reference_t<Range>> {
+			requireWritable();
+			const size_type count = static_cast<size_type>(std::ranges::distance(range));
+			if (mSize + count > capacity())
+				growTo(mSize + count);
+			std::ranges::uninitialized_copy(std::ranges::begin(range), std::ranges::end(range), raw_end(), std::unreachable_sentinel);
+			mSize += count;
+		}
+		void pop_back() requires (!read_only) {
+			requireWritable();
+			if (mSize > 0)
+				--mSize;
+		}
+		iterator erase(iterator pos) requires (!read_only) {
+			requireWritable();
+			pointer eraseElem = pos.base();
+			validatePosition(eraseElem);
+			if (eraseElem == raw_end()) return raw_end();
+
+			std::memmove(static_cast<void*>(eraseElem), static_cast<const void*>(eraseElem + 1), (raw_end() - eraseElem - 1) * sizeof(value_type));
+			--mSize;
+			return eraseElem;
+		}
+		iterator erase(iterator first, iterator last) requires (!read_only) {
+			requireWritable();
+			pointer eraseFirst = first.base();
+			pointer eraseLast = last.base();
+			validatePosition(eraseFirst);
+			validatePosition(eraseLast);
+			if (eraseLast < eraseFirst) throw std::out_of_range("position out of range");
+			if (eraseFirst == eraseLast) return eraseFirst;
+
+			std::memmove(static_cast<void*>(eraseFirst), static_cast<const void*>(eraseLast), (raw_end() - eraseLast) * sizeof(value_type));
+			mSize -= eraseLast - eraseFirst;
+			return eraseFirst;
+		}
+		iterator remove(iterator pos) requires (!read_only) {//unordered, the last element fills the hole
+			requireWritable();
+			pointer removeElem = pos.base();
+			validatePosition(removeElem);
+			if (removeElem == raw_end()) return raw_end();
+
+			*removeElem = raw_begin()[mSize - 1];
+			--mSize;
+			return removeElem;
+		}
+		void clear() requires (!read_only) {
+			requireWritable();
+			mSize = 0;
+		}
+		void flush() requires (!read_only) {//durable on return, the file still carries the capacity tail until trimmed
+			file.flush();
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept    { return mSize == 0; }
+		bool      isReadOnly()const noexcept { return file.isReadOnly(); }
+		size_type size()const noexcept       { return mSize; }
+		size_type capacity()const noexcept   { return file.size() / sizeof(value_type); }
+		const growth_type& growth_policy()const noexcept { return growth; }
+
+		void resize(size_type count) requires (!read_only) {//new elements are zero bytes, which for trivially copyable T is what value init gives for most types
+			requireWritable();
+			if (count > capacity())
+				tryReMap(count);
+			if (count > mSize)
+				std::memset(static_cast<void*>(raw_end()), 0, (count - mSize) * sizeof(value_type));
+			mSize = count;
+		}
+		void reserve(size_type newCap) requires (!read_only) {
+			if (newCap > capacity())
+				tryReMap(newCap);
+		}
+		void shrinkToFit() requires (!read_only) {
+			if (capacity() > mSize)
+				tryReMap(mSize);
+		}
+		void adviseSequential()noexcept {//one front to back scan coming, lets the kernel read ahead harder
+			file.adviseSequential();
+		}
+		//#################################################
+	private:
+		void trimFile()noexcept {
+			if (file.isReadOnly() || capacity() == mSize)
+				return;
+			try {
+				file.resize(mSize * sizeof(value_type));
+			}
+			catch (...) {}//the elements are all there, only the zero tail survives
+		}
+
+		//members
+		MappedFile file;
+		SEQ_NO_UNIQUE_ADDRESS growth_type growth;
+		size_type mSize = 0;
+	};
+}
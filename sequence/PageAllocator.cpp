@@ -0,0 +1,193 @@
+#include "PageAllocator.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace seq::pages {
+	namespace {
+		std::size_t lengthFor(std::size_t bytes, const PageOptions& options)noexcept {//whole pages, whole huge pages once there's one
+			const Support& os = support();
+			const std::size_t unit = options.policy != PagePolicy::normal && bytes >= os.hugePageSize ? os.hugePageSize : os.pageSize;
+			return (bytes + unit - 1) / unit * unit;
+		}
+		bool wantsHuge(std::size_t length, const PageOptions& options)noexcept {
+			return options.policy != PagePolicy::normal && length >= support().hugePageSize;
+		}
+		void touch(void* p, std::size_t length)noexcept {//fresh anonymous memory is zero, writing zero changes nothing but faults it in
+			volatile char* bytes = static_cast<volatile char*>(p);
+			const std::size_t step = support().pageSize;
+			for (std::size_t i = 0; i < length; i += step)
+				bytes[i] = 0;
+		}
+
+#if defined(_WIN32)
+		Support probe()noexcept {
+			Support os;
+			SYSTEM_INFO info;
+			::GetSystemInfo(&info);
+			os.pageSize = info.dwPageSize;
+			if (const SIZE_T large = ::GetLargePageMinimum())
+				os.hugePageSize = large;
+			ULONG highest = 0;
+			if (::GetNumaHighestNodeNumber(&highest))
+				os.nodes = unsigned(highest) + 1;
+			return os;
+		}
+		void* mapPages(std::size_t length, const PageOptions& options, DWORD extra)noexcept {
+			const DWORD type = MEM_RESERVE | MEM_COMMIT | extra;
+			if (options.node >= 0)
+				return ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, length, type, PAGE_READWRITE, DWORD(options.node));
+			return ::VirtualAlloc(nullptr, length, type, PAGE_READWRITE);
+		}
+	}
+
+	void* map(std::size_t bytes, const PageOptions& options) {
+		const std::size_t length = lengthFor(bytes, options);
+		void* p = nullptr;
+		if (options.policy == PagePolicy::reservedHuge && wantsHuge(length, options))
+			p = mapPages(length, options, MEM_LARGE_PAGES);//needs SeLockMemoryPrivilege, usually missing
+		if (!p)
+			p = mapPages(length, options, 0);
+		if (!p)
+			throw std::bad_alloc();
+		if (options.prefault)
+			touch(p, length);
+		return p;
+	}
+
+	void unmap(void* p, std::size_t, const PageOptions&)noexcept {
+		if (p)
+			::VirtualFree(p, 0, MEM_RELEASE);
+	}
+
+	static void* remapInPlace(void*, std::size_t, std::size_t, const PageOptions&)noexcept {
+		return nullptr;
+	}
+#else
+		Support probe()noexcept {
+			Support os;
+			if (const long size = ::sysconf(_SC_PAGESIZE); size > 0)
+				os.pageSize = std::size_t(size);
+#if defined(__linux__)
+			std::size_t huge = 0;
+			if (std::ifstream("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size") >> huge && huge > os.pageSize)
+				os.hugePageSize = huge;
+			std::string enabled;
+			if (std::getline(std::ifstream("/sys/kernel/mm/transparent_hugepage/enabled"), enabled))
+				os.transparentHuge = enabled.find("[never]") == std::string::npos;
+			std::string online;//"0", "0-1", "0,2-3"... the last number is the highest node
+			if (std::getline(std::ifstream("/sys/devices/system/node/online"), online)) {
+				const std::size_t digits = online.find_last_not_of("0123456789");
+				const std::string last = online.substr(digits == std::string::npos ? 0 : digits + 1);
+				if (!last.empty())
+					os.nodes = unsigned(std::stoul(last)) + 1;
+			}
+#endif
+			return os;
+		}
+		void* mapAnonymous(std::size_t length, int extraFlags)noexcept {
+			void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags, -1, 0);
+			return p == MAP_FAILED ? nullptr : p;
+		}
+		void* mapAligned(std::size_t length, std::size_t alignment)noexcept {//over map by one alignment, cut off both ends
+			char* raw = static_cast<char*>(mapAnonymous(length + alignment, 0));
+			if (!raw)
+				return nullptr;
+			char* start = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(raw) + alignment - 1) & ~std::uintptr_t(alignment - 1));
+			if (start > raw)
+				::munmap(raw, std::size_t(start - raw));
+			if (char* end = start + length; end < raw + length + alignment)
+				::munmap(end, std::size_t(raw + length + alignment - end));
+			return start;
+		}
+		void adviseHuge([[maybe_unused]] void* p, [[maybe_unused]] std::size_t length)noexcept {
+#if defined(MADV_HUGEPAGE)
+			::madvise(p, length, MADV_HUGEPAGE);//EINVAL on kernels without THP, the mapping just stays on base pages
+#endif
+		}
+		void bindTo([[maybe_unused]] void* p, [[maybe_unused]] std::size_t length, [[maybe_unused]] int node)noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+			//raw syscall, no libnuma needed. preferred rather than strict: a full node spills over instead of failing the fault
+			constexpr int mpolPreferred = 1;
+			if (node < 0 || node >= 64)
+				return;
+			const unsigned long mask = 1ul << node;
+			::syscall(SYS_mbind, p, length, mpolPreferred, &mask, 65ul, 0u);//ENOSYS/EPERM/EINVAL leave first touch in charge
+#endif
+		}
+	}
+
+	void* map(std::size_t bytes, const PageOptions& options) {
+		const std::size_t length = lengthFor(bytes, options);
+		void* p = nullptr;
+#if defined(MAP_HUGETLB)
+		if (options.policy == PagePolicy::reservedHuge && wantsHuge(length, options))
+			p = mapAnonymous(length, MAP_HUGETLB);//empty pool (the default) fails here
+#endif
+		if (!p) {
+			const bool huge = wantsHuge(length, options);
+			p = huge ? mapAligned(length, support().hugePageSize) : mapAnonymous(length, 0);
+			if (!p)
+				throw std::bad_alloc();
+			if (huge)
+				adviseHuge(p, length);
+		}
+		if (options.node >= 0)
+			bindTo(p, length, options.node);
+		if (options.prefault)
+			touch(p, length);
+		return p;
+	}
+
+	void unmap(void* p, std::size_t bytes, const PageOptions& options)noexcept {
+		if (p)
+			::munmap(p, lengthFor(bytes, options));
+	}
+
+	static void* remapInPlace([[maybe_unused]] void* p, [[maybe_unused]] std::size_t oldLength, [[maybe_unused]] std::size_t newLength,
+		[[maybe_unused]] const PageOptions& options)noexcept {
+#if defined(__linux__)
+		//the kernel moves the page tables, the vma keeps its advice and numa policy, the new tail inherits both
+		void* moved = ::mremap(p, oldLength, newLength, MREMAP_MAYMOVE);
+		if (moved == MAP_FAILED)
+			return nullptr;
+		if (wantsHuge(newLength, options))
+			adviseHuge(moved, newLength);//a block that crossed the huge page size was advised with base pages only
+		if (options.prefault && newLength > oldLength)
+			touch(static_cast<char*>(moved) + oldLength, newLength - oldLength);
+		return moved;
+#else
+		return nullptr;
+#endif
+	}
+#endif
+
+	const Support& support()noexcept {
+		static const Support os = probe();
+		return os;
+	}
+
+	void* remap(void* p, std::size_t oldBytes, std::size_t newBytes, const PageOptions& options) {
+		const std::size_t oldLength = lengthFor(oldBytes, options);
+		const std::size_t newLength = lengthFor(newBytes, options);
+		if (oldLength == newLength)
+			return p;
+		if (void* moved = remapInPlace(p, oldLength, newLength, options))
+			return moved;
+		void* fresh = map(newBytes, options);//no mremap here (or it refused, hugetlb pages), copy like any realloc
+		std::memcpy(fresh, p, std::min(oldBytes, newBytes));
+		unmap(p, oldBytes, options);
+		return fresh;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <algorithm>
+
+namespace seq {
+	enum class PagePolicy : unsigned char {
+		normal,         //plain mmap/VirtualAlloc, base pages
+		transparentHuge,//2MB aligned mapping with MADV_HUGEPAGE, the kernel backs it with huge pages as it can. normal pages elsewhere
+		reservedHuge    //MAP_HUGETLB / MEM_LARGE_PAGES from the preallocated pool, falls back to transparentHuge when that fails
+	};
+
+	struct PageOptions {
+		std::size_t threshold = std::size_t(1) << 21;//bytes, smaller blocks come from the heap, cache line aligned
+		PagePolicy policy = PagePolicy::transparentHuge;
+		int node = -1;        //numa node the pages are bound to (preferred, not strict), -1 leaves it to first touch
+		bool prefault = false;//touch every page on allocation: placement and page faults happen here instead of in the first pass
+
+		friend constexpr bool operator==(const PageOptions&, const PageOptions&) = default;
+	};
+
+	//the os side, PageAllocator.cpp. every feature degrades to the next best thing it can get: no huge pages means base pages,
+	//a failing mbind (no numa, not permitted in a container) means first touch, and none of that is reported as an error
+	namespace pages {
+		struct Support {
+			std::size_t pageSize = 4096;
+			std::size_t hugePageSize = std::size_t(1) << 21;
+			bool transparentHuge = false;//THP not switched off (linux "always" or "madvise")
+			unsigned nodes = 1;          //online numa nodes, 1 where unknown
+		};
+		const Support& support()noexcept;//probed once
+
+		//bytes are rounded up to whole (huge) pages the same way in all three, so unmap always matches what map got
+		void* map(std::size_t bytes, const PageOptions& options);//throws std::bad_alloc
+		void unmap(void* p, std::size_t bytes, const PageOptions& options)noexcept;
+		void* remap(void* p, std::size_t oldBytes, std::size_t newBytes, const PageOptions& options);//p is consumed on success only
+	}
+
+	//allocator for big Sequences: blocks of at least options.threshold bytes are their own page mapping (huge pages, numa node),
+	//smaller ones come from the heap. every block is at least cache line aligned, mapped ones page aligned, so aligned simd loads
+	//and streaming stores need no peeling at the front. relocatable growth of a mapped block is an mremap, no copy
+	//    Sequence<float, PageAllocator<float>> samples(PageAllocator<float>({ .node = 1, .prefault = true }));
+	template <typename T>
+	class PageAllocator {
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		static constexpr std::size_t alignment = std::max<std::size_t>(64, alignof(T));//guaranteed for every block
+
+		constexpr PageAllocator()noexcept = default;
+		constexpr explicit PageAllocator(const PageOptions& options)noexcept :opts(options) {}
+		template <typename U>
+		constexpr PageAllocator(const PageAllocator<U>& rhs)noexcept :opts(rhs.options()) {}
+
+		T* allocate(std::size_t count) {
+			const std::size_t bytes = count * sizeof(T);
+			if (isMapped(bytes))
+				return static_cast<T*>(pages::map(bytes, opts));
+			return static_cast<T*>(::operator new(bytes, std::align_val_t(alignment)));
+		}
+		void deallocate(T* p, std::size_t count)noexcept {
+			const std::size_t bytes = count * sizeof(T);
+			if (isMapped(bytes))
+				pages::unmap(p, bytes, opts);
+			else
+				::operator delete(p, std::align_val_t(alignment));
+		}
+		//only reached for relocatable T, so the bytes may simply move
+		T* reallocate(T* p, std::size_t oldCount, std::size_t newCount) {
+			const std::size_t oldBytes = oldCount * sizeof(T);
+			const std::size_t newBytes = newCount * sizeof(T);
+			if (isMapped(oldBytes) && isMapped(newBytes))
+				return static_cast<T*>(pages::remap(p, oldBytes, newBytes, opts));
+			T* moved = allocate(newCount);
+			std::memcpy(static_cast<void*>(moved), static_cast<const void*>(p), std::min(oldBytes, newBytes));
+			deallocate(p, oldCount);
+			return moved;
+		}
+
+		constexpr const PageOptions& options()const noexcept { return opts; }
+		constexpr bool isMapped(std::size_t bytes)const noexcept { return bytes >= opts.threshold && bytes > 0; }
+	private:
+		PageOptions opts;
+	};
+
+	template <typename T, typename U>
+	constexpr bool operator==(const PageAllocator<T>& lhs, const PageAllocator<U>& rhs)noexcept {
+		return lhs.options() == rhs.options();//the threshold decides how a block is freed, so it has to match
+	}
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "Sequence.h"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+
+namespace seq::parallel {
+	struct Options {
+		std::size_t grain = 0;                 //elements per task, 0 picks about 4 tasks per thread
+		std::size_t serialThreshold = 1 << 15; //below this nothing is handed to the pool
+		ThreadPool* pool = nullptr;            //nullptr means ThreadPool::global()
+	};
+
+	namespace detail {
+		inline ThreadPool& poolOf(const Options& options) {
+			return options.pool ? *options.pool : ThreadPool::global();
+		}
+		inline std::size_t grainOf(const Options& options, std::size_t count, const ThreadPool& pool) {
+			if (options.grain > 0)
+				return options.grain;
+			const std::size_t tasks = pool.size() * 4;
+			return std::max<std::size_t>((count + tasks - 1) / tasks, 1);
+		}
+		inline bool runSerial(const Options& options, std::size_t count, const ThreadPool& pool) {
+			return count < options.serialThreshold || pool.size() == 1;
+		}
+		//calls chunk(begin, end, chunkIndex) for every grain sized slice of [0, count), returns how many chunks there were
+		template <typename Chunk>
+		std::size_t forChunks(const Options& options, std::size_t count, Chunk chunk) {
+			if (count == 0)
+				return 0;
+			ThreadPool& pool = poolOf(options);
+			const std::size_t grain = grainOf(options, count, pool);
+			const std::size_t chunks = (count + grain - 1) / grain;
+
+			TaskGroup group(pool);
+			for (std::size_t c = 1; c < chunks; c++) {
+				group.run([&chunk, c, grain, count] {
+					chunk(c * grain, std::min(count, (c + 1) * grain), c);
+				});
+			}
+			chunk(0, std::min(count, grain), 0);//the caller takes the first slice itself
+			group.wait();
+			return chunks;
+		}
+	}
+
+	template <std::random_access_iterator It, typename Func>
+	void for_each(It first, It last, Func func, const Options& options = {}) {
+		const std::size_t count = static_cast<std::size_t>(last - first);
+		if (detail::runSerial(options, count, detail::poolOf(options))) {
+			std::for_each(first, last, func);
+			return;
+		}
+		detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+			std::for_each(first + begin, first + end, func);
+		});
+	}
+
+	template <std::random_access_iterator It, std::random_access_iterator Out, typename Func>
+	Out transform(It first, It last, Out out, Func func, const Options& options = {}) {
+		const std::size_t count = static_cast<std::size_t>(last - first);
+		if (detail::runSerial(options, count, detail::poolOf(options)))
+			return std::transform(first, last, out, func);
+
+		detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+			std::transform(first + begin, first + end, out + begin, func);
+		});
+		return out + count;
+	}
+
+	//op has to be associative, chunks are folded left to right so it doesn't have to be commutative
+	template <std::random_access_iterator It, typename T, typename BinaryOp = std::plus<>>
+	T reduce(It first, It last, T init, BinaryOp op = {}, const Options& options = {}) {
+		const std::size_t count = static_cast<std::size_t>(last - first);
+		ThreadPool& pool = detail::poolOf(options);
+		if (count == 0 || detail::runSerial(options, count, pool))
+			return std::accumulate(first, last, std::move(init), op);
+
+		const std::size_t grain = detail::grainOf(options, count, pool);
+		Sequence<T> partials((count + grain - 1) / grain, init);
+		detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			T acc = first[begin];
+			for (std::size_t i = begin + 1; i < end; i++)
+				acc = op(std::move(acc), first[i]);
+			partials[chunk] = std::move(acc);
+		});
+		for (const T& partial : partials)
+			init = op(std::move(init), partial);
+		return init;
+	}
+
+	//chunks are sorted in parallel, then merged pairwise in parallel rounds
+	template <std::random_access_iterator It, typename Compare = std::less<>>
+	void sort(It first, It last, Compare comp = {}, const Options& options = {}) {
+		const std::size_t count = static_cast<std::size_t>(last - first);
+		ThreadPool& pool = detail::poolOf(options);
+		if (detail::runSerial(options, count, pool)) {
+			std::sort(first, last, comp);
+			return;
+		}
+		const std::size_t grain = detail::grainOf(options, count, pool);
+		detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+			std::sort(first + begin, first + end, comp);
+		});
+		for (std::size_t width = grain; width < count; width *= 2) {
+			TaskGroup group(pool);
+			for (std::size_t begin = 0; begin + width < count; begin += 2 * width) {
+				const std::size_t middle = begin + width;
+				const std::size_t end = std::min(count, begin + 2 * width);
+				group.run([=, &comp] {
+					std::inplace_merge(first + begin, first + middle, first + end, comp);
+				});
+			}
+			group.wait();
+		}
+	}
+
+	//stable: every chunk flags its elements and counts, a prefix sum gives each chunk its output slots,
+	//then elements move out to a buffer and back. pred runs once per element. returns the partition point.
+	//the moves must not throw, types whose moves can go to std::stable_partition instead
+	template <std::random_access_iterator It, typename UnaryPred>
+	It partition(It first, It last, UnaryPred pred, const Options& options = {}) {
+		using value_type = std::iter_value_t<It>;
+		const std::size_t count = static_cast<std::size_t>(last - first);
+		ThreadPool& pool = detail::poolOf(options);
+		if (!strong_movable<value_type> || detail::runSerial(options, count, pool))
+			return std::stable_partition(first, last, pred);
+
+		const std::size_t grain = detail::grainOf(options, count, pool);
+		const std::size_t chunks = (count + grain - 1) / grain;
+		Sequence<unsigned char> flags(count);
+		Sequence<std::size_t> trueCount(chunks);
+		detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			std::size_t hits = 0;
+			for (std::size_t i = begin; i < end; i++) {
+				flags[i] = pred(first[i]) ? 1 : 0;
+				hits += flags[i];
+			}
+			trueCount[chunk] = hits;
+		});
+
+		Sequence<std::size_t> trueAt(chunks);
+		Sequence<std::size_t> falseAt(chunks);
+		std::size_t trues = 0;
+		for (std::size_t c = 0; c < chunks; c++) {
+			trueAt[c] = trues;
+			trues += trueCount[c];
+		}
+		for (std::size_t c = 0, falses = trues; c < chunks; c++) {
+			falseAt[c] = falses;
+			falses += std::min(count, (c + 1) * grain) - c * grain - trueCount[c];
+		}
+
+		//from the buffer's allocation to its release nothing may throw, elements sit half in it. moves can't, and a chunk
+		//whose task couldn't be scheduled runs on this thread instead, so everything that can fail is allocated up front
+		Sequence<unsigned char> movedOut(chunks);
+		Sequence<unsigned char> movedBack(chunks);
+		auto everyChunk = [&](Sequence<unsigned char>& done, auto move) {
+			try {
+				detail::forChunks(options, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+					move(begin, end, chunk);
+					done[chunk] = 1;
+				});
+			}
+			catch (...) {
+				for (std::size_t c = 0; c < chunks; c++) {
+					if (!done[c])
+						move(c * grain, std::min(count, (c + 1) * grain), c);
+				}
+			}
+		};
+
+		std::allocator<value_type> alloc;
+		value_type* buffer = alloc.allocate(count);
+		everyChunk(movedOut, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+			std::size_t t = trueAt[chunk];
+			std::size_t f = falseAt[chunk];
+			for (std::size_t i = begin; i < end; i++)
+				std::construct_at(buffer + (flags[i] ? t++ : f++), std::move(first[i]));
+		});
+		everyChunk(movedBack, [&](std::size_t begin, std::size_t end, std::size_t) {
+			std::move(buffer + begin, buffer + end, first + begin);
+			std::destroy(buffer + begin, buffer + end);
+		});
+		alloc.deallocate(buffer, count);
+		return first + trues;
+	}
+
+	//range overloads, anything with random access iterators: Sequence, SmallSequence, SequenceView and its slices, std containers
+	template <std::ranges::random_access_range Range, typename Func>
+	void for_each(Range&& range, Func func, const Options& options = {}) {
+		parallel::for_each(std::ranges::begin(range), std::ranges::end(range), std::move(func), options);
+	}
+	template <std::ranges::random_access_range Range, std::random_access_iterator Out, typename Func>
+	Out transform(Range&& range, Out out, Func func, const Options& options = {}) {
+		return parallel::transform(std::ranges::begin(range), std::ranges::end(range), out, std::move(func), options);
+	}
+	template <std::ranges::random_access_range Range, typename T, typename BinaryOp = std::plus<>>
+	T reduce(Range&& range, T init, BinaryOp op = {}, const Options& options = {}) {
+		return parallel::reduce(std::ranges::begin(range), std::ranges::end(range), std::move(init), std::move(op), options);
+	}
+	template <std::ranges::random_access_range Range, typename Compare = std::less<>>
+	void sort(Range&& range, Compare comp = {}, const Options& options = {}) {
+		parallel::sort(std::ranges::begin(range), std::ranges::end(range), std::move(comp), options);
+	}
+	template <std::ranges::random_access_range Range, typename UnaryPred>
+	std::ranges::iterator_t<Range> partition(Range&& range, UnaryPred pred, const Options& options = {}) {
+		return parallel::partition(std::ranges::begin(range), std::ranges::end(range), std::move(pred), options);
+	}
+}
@@ -0,0 +1,378 @@
+#pragma once
+
+#include "Sequence.h"
+#include <concepts>
+#include <functional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//lazy filter/transform/take/zip/enumerate chains that run as one fused loop.
+//push based: the terminal (collect, for_each, reduce, count) wraps its sink in every stage from the last one back, then the
+//source walks once and hands each element down the nested calls, which inline into a single loop body. there is no iterator
+//to step and no intermediate Sequence. a stage returns false to stop the source early (take)
+//    auto out = values | pipe::filter(isOdd) | pipe::transform(square) | pipe::take(100) | pipe::collect();
+namespace seq::pipe {
+	//what a stage knows of how many elements come out of it, collect sizes its output from this
+	struct Extent {
+		enum Bound : unsigned char { exact, atMost, unknown };
+		std::size_t count = 0;
+		Bound bound = unknown;
+	};
+
+	namespace detail {
+		//an element the way a stage holds on to it: lvalues by reference, temporaries by value
+		template <typename Ref>
+		using held_t = std::conditional_t<std::is_lvalue_reference_v<Ref>, Ref, std::remove_cvref_t<Ref>>;
+
+		//value type collect() defaults to, pairs of references decay to pairs of values
+		template <typename Ref>
+		struct collected { using type = std::remove_cvref_t<Ref>; };
+		template <typename A, typename B>
+		struct collected<std::pair<A, B>> { using type = std::pair<std::remove_cvref_t<A>, std::remove_cvref_t<B>>; };
+		template <typename Ref>
+		using collected_t = typename collected<std::remove_cvref_t<Ref>>::type;
+
+		template <typename Range>
+		class RangeSource {
+		public:
+			using reference = std::ranges::range_reference_t<Range>;
+
+			explicit RangeSource(Range range) :range(std::move(range)) {}
+
+			Extent extent() {
+				if constexpr (std::ranges::sized_range<Range>)
+					return { std::size_t(std::ranges::size(range)), Extent::exact };
+				else
+					return {};
+			}
+			template <typename Sink>
+			void feed(Sink& sink) {
+				for (auto&& elem : range) {
+					if (!sink(std::forward<decltype(elem)>(elem)))
+						return;
+				}
+			}
+		private:
+			Range range;
+		};
+
+		//walks both in step, ends with the shorter one
+		template <typename First, typename Second>
+		class ZipSource {
+		public:
+			using reference = std::pair<held_t<std::ranges::range_reference_t<First>>, held_t<std::ranges::range_reference_t<Second>>>;
+
+			ZipSource(First first, Second second) :first(std::move(first)), second(std::move(second)) {}
+
+			Extent extent() {
+				if constexpr (std::ranges::sized_range<First> && std::ranges::sized_range<Second>)
+					return { std::min<std::size_t>(std::ranges::size(first), std::ranges::size(second)), Extent::exact };
+				else
+					return {};
+			}
+			template <typename Sink>
+			void feed(Sink& sink) {
+				auto lhs = std::ranges::begin(first);
+				auto rhs = std::ranges::begin(second);
+				const auto lhsEnd = std::ranges::end(first);
+				const auto rhsEnd = std::ranges::end(second);
+				for (; lhs != lhsEnd && rhs != rhsEnd; ++lhs, ++rhs) {
+					if (!sink(reference(*lhs, *rhs)))
+						return;
+				}
+			}
+		private:
+			First first;
+			Second second;
+		};
+
+		template <typename Ref, typename... Stages>
+		struct output { using type = Ref; };
+		template <typename Ref, typename Stage, typename... Rest>
+		struct output<Ref, Stage, Rest...> { using type = typename output<typename Stage::template output<Ref>, Rest...>::type; };
+	}
+	//#################################################
+
+	//STAGES, wrap(next) returns the callable the stage before pushes into: bool(element), false means stop
+	template <typename Pred>
+	struct Filter {
+		template <typename Ref>
+		using output = Ref;
+
+		static constexpr Extent extent(Extent in)noexcept {
+			return { in.count, in.bound == Extent::unknown ? Extent::unknown : Extent::atMost };
+		}
+		template <typename Next>
+		auto wrap(Next& next) {
+			return [this, &next](auto&& elem) {
+				if (std::invoke(pred, std::as_const(elem)))
+					return next(std::forward<decltype(elem)>(elem));
+				return true;
+			};
+		}
+
+		Pred pred;
+	};
+
+	template <typename Func>
+	struct Transform {
+		template <typename Ref>
+		using output = std::invoke_result_t<Func&, Ref>;
+
+		static constexpr Extent extent(Extent in)noexcept { return in; }
+		template <typename Next>
+		auto wrap(Next& next) {
+			return [this, &next](auto&& elem) {
+				return next(std::invoke(func, std::forward<decltype(elem)>(elem)));
+			};
+		}
+
+		Func func;
+	};
+
+	struct Take {
+		template <typename Ref>
+		using output = Ref;
+
+		constexpr Extent extent(Extent in)const noexcept {
+			if (in.bound == Extent::unknown)
+				return { count, Extent::atMost };
+			return { std::min(count, in.count), in.bound };
+		}
+		template <typename Next>
+		auto wrap(Next& next) {
+			return [&next, left = count](auto&& elem) mutable {
+				if (left == 0)
+					return false;
+				--left;
+				return next(std::forward<decltype(elem)>(elem)) && left != 0;//stop right after the last one, not on the one past it
+			};
+		}
+
+		std::size_t count;
+	};
+
+	struct Enumerate {
+		template <typename Ref>
+		using output = std::pair<std::size_t, detail::held_t<Ref>>;
+
+		static constexpr Extent extent(Extent in)noexcept { return in; }
+		template <typename Next>
+		auto wrap(Next& next) {
+			return [&next, index = std::size_t(0)](auto&& elem) mutable {
+				return next(output<decltype(elem)>(index++, std::forward<decltype(elem)>(elem)));
+			};
+		}
+	};
+
+	template <typename Stage>
+	struct is_stage : std::false_type {};
+	template <typename Pred>
+	struct is_stage<Filter<Pred>> : std::true_type {};
+	template <typename Func>
+	struct is_stage<Transform<Func>> : std::true_type {};
+	template <>
+	struct is_stage<Take> : std::true_type {};
+	template <>
+	struct is_stage<Enumerate> : std::true_type {};
+	template <typename Stage>
+	concept stage = is_stage<std::remove_cvref_t<Stage>>::value;
+
+	template <typename Pred>
+	Filter<std::decay_t<Pred>> filter(Pred&& pred) { return { std::forward<Pred>(pred) }; }
+	template <typename Func>
+	Transform<std::decay_t<Func>> transform(Func&& func) { return { std::forward<Func>(func) }; }
+	inline Take take(std::size_t count)noexcept { return { count }; }
+	inline Enumerate enumerate()noexcept { return {}; }
+	//#################################################
+
+	//a source and the stages after it, nothing runs until a terminal is applied. holds lvalue ranges by reference
+	//(std::views::all), so the range has to outlive the pipeline, rvalue ranges are moved in
+	template <typename Source, typename... Stages>
+	class Pipeline {
+	public:
+		using reference = typename detail::output<typename Source::reference, Stages...>::type;
+
+		Pipeline(Source source, std::tuple<Stages...> stages) :source(std::move(source)), stages(std::move(stages)) {}
+
+		template <stage Stage>
+		Pipeline<Source, Stages..., std::remove_cvref_t<Stage>> then(Stage&& next)const& {
+			return { source, std::tuple_cat(stages, std::make_tuple(std::forward<Stage>(next))) };
+		}
+		template <stage Stage>
+		Pipeline<Source, Stages..., std::remove_cvref_t<Stage>> then(Stage&& next)&& {
+			return { std::move(source), std::tuple_cat(std::move(stages), std::make_tuple(std::forward<Stage>(next))) };
+		}
+
+		Extent extent() {
+			return std::apply([this](const Stages&... each) {
+				Extent in = source.extent();
+				((in = each.extent(in)), ...);
+				return in;
+			}, stages);
+		}
+		//the one loop, sink gets every element that makes it through as a reference, returns false to stop
+		template <typename Sink>
+		void run(Sink& sink) {
+			drive<sizeof...(Stages)>(sink);
+		}
+
+		//TERMINALS
+		//an exact extent is written straight into append_uninitialized space for trivial types, else reserved once. an upper
+		//bound (after filter) is reserved whole and not shrunk, call shrinkToFit if the survivors are few and the result lives long
+		template <typename Out = Sequence<detail::collected_t<reference>>>
+		Out collect() {
+			Out out;
+			const Extent extent = this->extent();
+			using value_type = typename Out::value_type;
+			if constexpr (requires(Out& o) { { o.append_uninitialized(extent.count) } -> std::same_as<value_type*>; }) {
+				if constexpr (std::is_trivially_copyable_v<value_type> && std::is_trivially_default_constructible_v<value_type>) {
+					if (extent.bound == Extent::exact) {
+						value_type* dest = out.append_uninitialized(extent.count);
+						value_type* const first = dest;
+						auto write = [&dest](auto&& elem) {
+							*dest++ = value_type(std::forward<decltype(elem)>(elem));
+							return true;
+						};
+						try {
+							run(write);
+						}
+						catch (...) {
+							out.resize_shrink(std::size_t(dest - first));
+							throw;
+						}
+						assert(dest == first + extent.count && "a stage produced a different count than its extent promised");
+						return out;
+					}
+				}
+			}
+			if constexpr (requires(Out& o) { o.reserve(extent.count); }) {
+				if (extent.bound != Extent::unknown)
+					out.reserve(extent.count);
+			}
+			auto append = [&out](auto&& elem) {
+				out.emplace_back(std::forward<decltype(elem)>(elem));
+				return true;
+			};
+			run(append);
+			return out;
+		}
+		template <typename Func>
+		void for_each(Func func) {
+			auto call = [&func](auto&& elem) {
+				std::invoke(func, std::forward<decltype(elem)>(elem));
+				return true;
+			};
+			run(call);
+		}
+		template <typename T, typename BinaryOp = std::plus<>>
+		T reduce(T init, BinaryOp op = {}) {
+			auto fold = [&init, &op](auto&& elem) {
+				init = std::invoke(op, std::move(init), std::forward<decltype(elem)>(elem));
+				return true;
+			};
+			run(fold);
+			return init;
+		}
+		std::size_t count() {
+			std::size_t seen = 0;
+			auto tally = [&seen](auto&&) {
+				++seen;
+				return true;
+			};
+			run(tally);
+			return seen;
+		}
+		//#################################################
+	private:
+		//wraps the sink in the stages from the last one back to the first, then lets the source push into the outermost
+		template <std::size_t Remaining, typename Sink>
+		void drive(Sink& sink) {
+			if constexpr (Remaining == 0) {
+				source.feed(sink);
+			}
+			else {
+				auto wrapped = std::get<Remaining - 1>(stages).wrap(sink);
+				drive<Remaining - 1>(wrapped);
+			}
+		}
+
+		Source source;
+		SEQ_NO_UNIQUE_ADDRESS std::tuple<Stages...> stages;
+	};
+
+	template <std::ranges::viewable_range Range>
+	Pipeline<detail::RangeSource<std::views::all_t<Range>>> from(Range&& range) {
+		return { detail::RangeSource<std::views::all_t<Range>>(std::views::all(std::forward<Range>(range))), {} };
+	}
+	//elements are std::pair<first element, second element>, references where the ranges give references
+	template <std::ranges::viewable_range First, std::ranges::viewable_range Second>
+	Pipeline<detail::ZipSource<std::views::all_t<First>, std::views::all_t<Second>>> zip(First&& first, Second&& second) {
+		return { { std::views::all(std::forward<First>(first)), std::views::all(std::forward<Second>(second)) }, {} };
+	}
+
+	template <typename P>
+	struct is_pipeline : std::false_type {};
+	template <typename Source, typename... Stages>
+	struct is_pipeline<Pipeline<Source, Stages...>> : std::true_type {};
+	template <typename P>
+	concept pipeline = is_pipeline<std::remove_cvref_t<P>>::value;
+	//#################################################
+
+	//TERMINAL OBJECTS, for the pipe syntax. each one just calls the member of the same name
+	template <typename Out = void>
+	struct Collect {};
+	template <typename Func>
+	struct ForEach { Func func; };
+	template <typename T, typename BinaryOp>
+	struct Reduce { T init; BinaryOp op; };
+	struct Count {};
+
+	template <typename Out = void>
+	Collect<Out> collect()noexcept { return {}; }
+	template <typename Func>
+	ForEach<std::decay_t<Func>> for_each(Func&& func) { return { std::forward<Func>(func) }; }
+	template <typename T, typename BinaryOp = std::plus<>>
+	Reduce<T, BinaryOp> reduce(T init, BinaryOp op = {}) { return { std::move(init), std::move(op) }; }
+	inline Count count()noexcept { return {}; }
+
+	//range | stage starts a pipeline, pipeline | stage extends it, either | terminal runs it
+	template <std::ranges::viewable_range Range, stage Stage> requires (!pipeline<Range>)
+	auto operator|(Range&& range, Stage&& next) {
+		return from(std::forward<Range>(range)).then(std::forward<Stage>(next));
+	}
+	template <pipeline P, stage Stage>
+	auto operator|(P&& pipe, Stage&& next) {
+		return std::forward<P>(pipe).then(std::forward<Stage>(next));
+	}
+
+	template <typename P>
+	decltype(auto) asPipeline(P&& p) {
+		if constexpr (pipeline<P>)
+			return std::forward<P>(p);
+		else
+			return from(std::forward<P>(p));
+	}
+	template <typename P, typename Out> requires pipeline<P> || std::ranges::viewable_range<P>
+	auto operator|(P&& p, Collect<Out>) {
+		auto&& chain = asPipeline(std::forward<P>(p));
+		if constexpr (std::is_void_v<Out>)
+			return chain.collect();
+		else
+			return chain.template collect<Out>();
+	}
+	template <typename P, typename Func> requires pipeline<P> || std::ranges::viewable_range<P>
+	void operator|(P&& p, ForEach<Func> terminal) {
+		asPipeline(std::forward<P>(p)).for_each(std::move(terminal.func));
+	}
+	template <typename P, typename T, typename BinaryOp> requires pipeline<P> || std::ranges::viewable_range<P>
+	T operator|(P&& p, Reduce<T, BinaryOp> terminal) {
+		return asPipeline(std::forward<P>(p)).reduce(std::move(terminal.init), std::move(terminal.op));
+	}
+	template <typename P> requires pipeline<P> || std::ranges::viewable_range<P>
+	std::size_t operator|(P&& p, Count) {
+		return asPipeline(std::forward<P>(p)).count();
+	}
+}
@@ -0,0 +1,218 @@
+#include "Profiler.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
+namespace seq::profile {
+	namespace {
+		struct Registry {
+			std::mutex lock;
+			std::deque<detail::Ring> rings;//deque, rings never move once a thread points at one
+		};
+		Registry& registry() {//never destroyed, threads may still close zones while statics are torn down
+			static Registry* instance = new Registry;
+			return *instance;
+		}
+
+		struct Anchor {
+			std::uint64_t ticks;
+			std::chrono::steady_clock::time_point time;
+		};
+		const Anchor& startup() {//first zone, first Session or first conversion, whichever comes first
+			static const Anchor anchor = { now(), std::chrono::steady_clock::now() };
+			return anchor;
+		}
+
+		std::string escapeJson(std::string_view text) {
+			std::string escaped;
+			for (char c : text) {
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+		ZoneStats summarizeZone(std::string name, Sequence<double> samples) {
+			ZoneStats zone;
+			zone.name = std::move(name);
+			zone.calls = samples.size();
+			for (double sample : samples)
+				zone.total += sample;
+			zone.max = samples.isEmpty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+			const bench::Stats stats = bench::summarize(std::move(samples));//same nearest rank p99 as the benchmarks
+			zone.min = stats.min;
+			zone.avg = stats.mean;
+			zone.p99 = stats.p99;
+			return zone;
+		}
+	}
+
+	double ticksPerNano() {
+#if defined(SEQ_PROFILE_TSC)
+		static const double rate = [] {//the longer the span the better, programs that ran a while pay nothing here
+			using clock = std::chrono::steady_clock;
+			constexpr std::chrono::milliseconds window(50);
+			const Anchor& from = startup();
+			if (const auto elapsed = clock::now() - from.time; elapsed < window)
+				std::this_thread::sleep_for(window - elapsed);
+			const std::uint64_t ticks = now();
+			const auto time = clock::now();
+			return double(ticks - from.ticks) / std::chrono::duration<double, std::nano>(time - from.time).count();
+		}();
+		return rate;
+#else
+		using period = std::chrono::steady_clock::period;
+		return double(period::den) / double(period::num) / 1e9;
+#endif
+	}
+
+	namespace detail {
+		Ring::Ring(std::uint32_t thread, std::string name) :thread(thread), name(std::move(name)) {
+			events.resize_for_overwrite(capacity);
+		}
+
+		Ring& attachThread() {
+			startup();
+			Registry& reg = registry();
+			std::lock_guard<std::mutex> guard(reg.lock);
+			const std::uint32_t id = std::uint32_t(reg.rings.size());
+			Ring& ring = reg.rings.emplace_back(id, "thread " + std::to_string(id));
+			localRing = &ring;
+			return ring;
+		}
+	}
+
+	void setEnabled(bool on)noexcept {
+		detail::enabled.store(on, std::memory_order_relaxed);
+	}
+
+	void nameThread(std::string name) {
+		detail::Ring* ring = detail::localRing ? detail::localRing : &detail::attachThread();
+		std::lock_guard<std::mutex> guard(registry().lock);
+		ring->name = std::move(name);
+	}
+
+	Session::Session() :Session(SessionOptions()) {}
+	Session::Session(SessionOptions options) :opts(options), epoch(startup().ticks), frameBegin(now()) {
+		opts.history = std::max<std::size_t>(opts.history, 1);
+		trace.reserve(opts.traceEvents);
+	}
+
+	const FrameStats& Session::endFrame() {
+		const std::uint64_t frameEnd = now();
+		const double nanosPerTick = 1.0 / ticksPerNano();
+
+		Sequence<Event> events;
+		std::size_t dropped = 0;
+		{
+			Registry& reg = registry();
+			std::lock_guard<std::mutex> guard(reg.lock);//only keeps new threads from growing the deque under us
+			for (detail::Ring& ring : reg.rings) {
+				ring.drain([&](const Event& event) {
+					events.push_back(event);
+					if (opts.traceEvents == 0)
+						return;
+					if (trace.size() < opts.traceEvents) {
+						trace.push_back(TraceEvent{ event, ring.thread });
+					}
+					else {
+						trace[traceNext] = TraceEvent{ event, ring.thread };
+						traceNext = (traceNext + 1) % opts.traceEvents;
+					}
+				});
+				dropped += ring.takeDropped();
+			}
+		}
+
+		//the same literal may have a different address in every translation unit, so zones are told apart by text
+		std::sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+			return std::string_view(lhs.name) < std::string_view(rhs.name);
+		});
+		last.zones.clear();
+		for (std::size_t first = 0; first < events.size();) {
+			const std::string_view name(events[first].name);
+			Sequence<double> samples;
+			std::size_t end = first;
+			for (; end < events.size() && std::string_view(events[end].name) == name; ++end)
+				samples.push_back(double(events[end].end - events[end].begin) * nanosPerTick);
+			last.zones.push_back(summarizeZone(std::string(name), std::move(samples)));
+			remember(name, last.zones.back().total, end - first);
+			first = end;
+		}
+
+		last.index++;
+		last.duration = double(frameEnd - frameBegin) * nanosPerTick;
+		last.dropped = dropped;
+		remember("frame", last.duration, 1);
+		frameBegin = frameEnd;
+		return last;
+	}
+
+	void Session::remember(std::string_view name, double total, std::size_t calls) {
+		auto found = std::find_if(histories.begin(), histories.end(), [name](const History& history) { return history.name == name; });
+		if (found == histories.end()) {
+			histories.push_back(History{ std::string(name), {}, 0, 0 });
+			found = histories.end() - 1;
+		}
+		History& history = *found;
+		if (history.totals.size() < opts.history)
+			history.totals.push_back(total);
+		else
+			history.totals[history.next] = total;
+		history.next = (history.next + 1) % opts.history;
+		history.calls += calls;
+	}
+
+	Sequence<ZoneStats> Session::rolling()const {
+		Sequence<ZoneStats> zones;
+		zones.reserve(histories.size());
+		for (const History& history : histories) {
+			zones.push_back(summarizeZone(history.name, history.totals));
+			zones.back().calls = history.calls;
+		}
+		return zones;
+	}
+
+	void Session::report(std::ostream& out)const {
+		out << std::left << std::setw(32) << "zone" << std::right << std::setw(10) << "calls" << std::setw(12) << "min us"
+			<< std::setw(12) << "avg us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << '\n';
+		out << std::fixed << std::setprecision(1);
+		for (const ZoneStats& zone : rolling()) {
+			out << std::left << std::setw(32) << zone.name << std::right << std::setw(10) << zone.calls << std::setw(12) << zone.min / 1000.0
+				<< std::setw(12) << zone.avg / 1000.0 << std::setw(12) << zone.p99 / 1000.0 << std::setw(12) << zone.max / 1000.0 << '\n';
+		}
+		out.unsetf(std::ios::floatfield);
+		if (last.dropped > 0)
+			out << last.dropped << " events dropped in the last frame, rings full\n";
+	}
+
+	void Session::writeChromeTrace(std::ostream& out)const {
+		const double microsPerTick = 1.0 / ticksPerNano() / 1000.0;
+		out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+		bool first = true;
+		{
+			Registry& reg = registry();
+			std::lock_guard<std::mutex> guard(reg.lock);
+			for (const detail::Ring& ring : reg.rings) {
+				out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << ring.thread
+					<< ", \"args\": {\"name\": \"" << escapeJson(ring.name) << "\"}}";
+				first = false;
+			}
+		}
+		out << std::fixed << std::setprecision(3);
+		for (std::size_t i = 0; i < trace.size(); i++) {
+			const TraceEvent& t = trace[(traceNext + i) % trace.size()];//oldest first once the buffer wrapped
+			const double begin = t.event.begin >= epoch ? double(t.event.begin - epoch) * microsPerTick : 0.0;
+			out << (first ? "" : ",\n") << "{\"name\": \"" << escapeJson(t.event.name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t.thread
+				<< ", \"ts\": " << begin << ", \"dur\": " << double(t.event.end - t.event.begin) * microsPerTick << '}';
+			first = false;
+		}
+		out.unsetf(std::ios::floatfield);
+		out << "\n]}\n";
+	}
+}
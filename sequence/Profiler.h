@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Sequence.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(SEQ_PROFILE_STEADY_CLOCK)
+#define SEQ_PROFILE_TSC 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+//scoped zones for always on profiling. a zone is two clock reads and one store into a ring buffer owned by the calling thread,
+//no lock, no allocation, no string copy. a Session drains every thread's ring once per frame into per zone stats and, if
+//asked, into a Chrome trace (chrome://tracing, ui.perfetto.dev). pair it with FrameTimer::Pace for the frame loop:
+//    FrameTimer timer(120);
+//    profile::Session session;
+//    while (running) {
+//        { SEQ_PROFILE_ZONE("physics"); step(); }
+//        session.endFrame();
+//        timer.Pace();
+//    }
+//define SEQ_NO_PROFILE to compile the zones out, profile::setEnabled(false) turns them into one relaxed load at run time
+namespace seq::profile {
+	//x86 reads the time stamp counter (invariant on every cpu of the last decade), everything else steady_clock, which is a
+	//vDSO clock_gettime on linux. SEQ_PROFILE_STEADY_CLOCK forces the latter. ticks become nanoseconds only when reported
+	inline std::uint64_t now()noexcept {
+#if defined(SEQ_PROFILE_TSC)
+		return __rdtsc();
+#else
+		return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+	double ticksPerNano();//calibrated against steady_clock on first use, waits out the rest of 50ms after startup then
+
+	struct Event {
+		const char* name;//static storage, zone names are string literals
+		std::uint64_t begin;
+		std::uint64_t end;
+	};
+
+	namespace detail {
+		//single producer (the owning thread) single consumer (the Session) ring. full means the event is dropped and counted,
+		//the producer never waits
+		class Ring {
+		public:
+			static constexpr std::size_t capacity = std::size_t(1) << 14;//power of two, 384KB per thread that ever opened a zone
+
+			Ring(std::uint32_t thread, std::string name);
+
+			void push(const Event& event)noexcept {
+				const std::uint64_t at = head.load(std::memory_order_relaxed);
+				if (at - cachedTail == capacity) {//only reread the consumer's cache line when the stale copy says full
+					cachedTail = tail.load(std::memory_order_acquire);
+					if (at - cachedTail == capacity) {
+						dropped.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+				}
+				events[at & (capacity - 1)] = event;
+				head.store(at + 1, std::memory_order_release);
+			}
+			template <typename Sink>
+			void drain(Sink sink) {
+				std::uint64_t at = tail.load(std::memory_order_relaxed);
+				const std::uint64_t end = head.load(std::memory_order_acquire);
+				for (; at != end; ++at)
+					sink(events[at & (capacity - 1)]);
+				tail.store(at, std::memory_order_release);
+			}
+			std::size_t takeDropped()noexcept { return dropped.exchange(0, std::memory_order_relaxed); }
+
+			const std::uint32_t thread;//small sequential id, the trace's tid
+			std::string name;          //set by nameThread, under the registry lock
+		private:
+			alignas(64) std::atomic<std::uint64_t> head = 0;
+			std::uint64_t cachedTail = 0;//producer's copy
+			alignas(64) std::atomic<std::uint64_t> tail = 0;
+			std::atomic<std::size_t> dropped = 0;
+			Sequence<Event> events;
+		};
+
+		Ring& attachThread();//registers the calling thread's ring, once per thread. rings outlive their threads
+		inline thread_local Ring* localRing = nullptr;
+		inline std::atomic<bool> enabled = true;
+	}
+
+	inline void record(const char* name, std::uint64_t begin, std::uint64_t end)noexcept {
+		detail::Ring* ring = detail::localRing;
+		if (!ring) {
+			try {
+				ring = &detail::attachThread();
+			}
+			catch (...) {
+				return;//no memory for a ring, this event is lost
+			}
+		}
+		ring->push(Event{ name, begin, end });
+	}
+	inline bool isEnabled()noexcept { return detail::enabled.load(std::memory_order_relaxed); }
+	void setEnabled(bool on)noexcept;
+	void nameThread(std::string name);//shows up in the trace instead of "thread N"
+
+	class Zone {
+	public:
+		explicit Zone(const char* name)noexcept :name(name), begin(isEnabled() ? now() : 0) {}
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+		~Zone() {
+			if (begin)
+				record(name, begin, now());
+		}
+	private:
+		const char* name;
+		std::uint64_t begin;
+	};
+
+	struct ZoneStats {//nanoseconds
+		std::string name;
+		std::size_t calls = 0;
+		double total = 0.0;
+		double min = 0.0;
+		double avg = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	struct FrameStats {
+		std::uint64_t index = 0;
+		double duration = 0.0;      //nanoseconds between this endFrame and the previous one
+		Sequence<ZoneStats> zones;  //per call over the frame, sorted by name
+		std::size_t dropped = 0;    //events lost to full rings since the last frame
+	};
+
+	struct SessionOptions {
+		std::size_t history = 120;  //frames the rolling stats look back over
+		std::size_t traceEvents = 0;//raw events kept for writeChromeTrace, the oldest go first. 0 keeps none
+	};
+
+	//the consumer side. one Session drains at a time, events recorded before it existed land in its first frame
+	class Session {
+	public:
+		Session();
+		explicit Session(SessionOptions options);
+
+		const FrameStats& endFrame();//drains every ring, closes the frame
+		const FrameStats& lastFrame()const noexcept { return last; }
+		//per zone over the last history frames, each sample one frame's total in that zone. "frame" is the frame itself
+		Sequence<ZoneStats> rolling()const;
+		void report(std::ostream& out)const;//rolling(), as a table
+		void writeChromeTrace(std::ostream& out)const;//complete ("X") events plus thread names, timestamps in microseconds
+
+	private:
+		struct TraceEvent {
+			Event event;
+			std::uint32_t thread;
+		};
+		struct History {
+			std::string name;
+			Sequence<double> totals;//circular, history long
+			std::size_t next = 0;
+			std::size_t calls = 0;
+		};
+		void remember(std::string_view name, double total, std::size_t calls);
+
+		SessionOptions opts;
+		std::uint64_t epoch;     //ticks, trace time zero
+		std::uint64_t frameBegin;
+		FrameStats last;
+		Sequence<History> histories;
+		Sequence<TraceEvent> trace;//circular once full
+		std::size_t traceNext = 0;
+	};
+}
+
+#if defined(SEQ_NO_PROFILE)
+#define SEQ_PROFILE_ZONE(name)
+#else
+#define SEQ_PROFILE_CONCAT_(a, b) a##b
+#define SEQ_PROFILE_CONCAT(a, b) SEQ_PROFILE_CONCAT_(a, b)
+#define SEQ_PROFILE_ZONE(name) ::seq::profile::Zone SEQ_PROFILE_CONCAT(seqProfileZone, __LINE__)(name)
+#endif
@@ -1,20 +1,113 @@
 #pragma once
 
 #include <assert.h>
+#include <cstring>
 #include <stdexcept>
 #include <memory>
+#include <memory_resource>
 #include <concepts>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include "Growth.h"
+#include "Simd.h"
+#include "SequenceView.h"
+#include "Instrument.h"
 
 namespace seq {
 	template <typename T>
 	concept strong_movable = std::movable<T> && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
 
+	//a relocatable type can be moved to a new address with a raw byte copy and the old bytes simply forgotten (no destructor call).
+	//everything trivially copyable qualifies, user types opt in (or out) by specializing this
 	template <typename T>
+	struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+	template <typename T>
+	inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+	//allocators that can grow/shrink a block in place (or move it themselves, realloc style). the old block is consumed on success
+	template <typename Alloc>
+	concept reallocating_allocator = requires(Alloc a, typename std::allocator_traits<Alloc>::value_type* p, std::size_t n) {
+		{ a.reallocate(p, n, n) } -> std::same_as<typename std::allocator_traits<Alloc>::value_type*>;
+	};
+
+	//allocators that can tell how many elements really fit in a block they handed out.
+	//implies deallocate doesn't care about the count, since the Sequence will then remember the bigger number
+	template <typename Alloc>
+	concept usable_size_allocator = requires(const Alloc a, typename std::allocator_traits<Alloc>::value_type* p) {
+		{ a.usable_size(p) } -> std::convertible_to<std::size_t>;
+	};
+
+	namespace detail {
+		//the std uninitialized algorithms only become constexpr in C++26. while constant evaluating these construct one by one
+		//through construct_at instead, no cleanup needed there since a throw ends the evaluation anyway
+		template <typename It, typename S, typename T>
+		constexpr T* uninitialized_copy(It first, S last, T* dest) {
+			if (std::is_constant_evaluated()) {
+				for (; first != last; ++first, ++dest)
+					std::construct_at(dest, *first);
+				return dest;
+			}
+			if constexpr (std::is_same_v<It, S>)
+				return std::uninitialized_copy(first, last, dest);
+			else
+				return std::ranges::uninitialized_copy(std::move(first), last, dest, std::unreachable_sentinel).out;
+		}
+		template <typename It, typename T>
+		constexpr T* uninitialized_move(It first, It last, T* dest) {
+			if (std::is_constant_evaluated()) {
+				for (; first != last; ++first, ++dest)
+					std::construct_at(dest, std::move(*first));
+				return dest;
+			}
+			return std::uninitialized_move(first, last, dest);
+		}
+		template <typename T, typename V>
+		constexpr T* uninitialized_fill_n(T* dest, std::size_t count, const V& value) {
+			if (std::is_constant_evaluated()) {
+				for (; count > 0; --count, ++dest)
+					std::construct_at(dest, value);
+				return dest;
+			}
+			return std::uninitialized_fill_n(dest, count, value);
+		}
+		template <typename T>
+		constexpr T* uninitialized_value_construct_n(T* dest, std::size_t count) {
+			if (std::is_constant_evaluated()) {
+				for (; count > 0; --count, ++dest)
+					std::construct_at(dest);
+				return dest;
+			}
+			return std::uninitialized_value_construct_n(dest, count);
+		}
+		template <typename T>
+		constexpr T* uninitialized_default_construct_n(T* dest, std::size_t count) {
+			if (std::is_constant_evaluated())//default initialization isn't expressible here, value initialized is a valid "garbage"
+				return uninitialized_value_construct_n(dest, count);
+			return std::uninitialized_default_construct_n(dest, count);
+		}
+	}
+
+	//a Sequence's block handed out by release() or handed in to the adopting constructor: size live elements at the front of
+	//capacity slots, allocated by an allocator equal to the Sequence's
+	template <typename T>
+	struct SequenceBuffer {
+		T* data = nullptr;
+		std::size_t size = 0;
+		std::size_t capacity = 0;
+	};
+	struct adopt_buffer_t { explicit adopt_buffer_t() = default; };
+	inline constexpr adopt_buffer_t adopt_buffer{};
+
+	template <typename T, typename Allocator = std::allocator<T>, typename Growth = GrowGeometric>
 	class Sequence {
 	private:
 		static_assert(std::is_object_v<T>, "T must be an object type");
 		static_assert(std::destructible<T>, "T must be destructible");
 		static_assert(!std::is_const_v<T>, "T cannot be const type");
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>, "Allocator::value_type must be T");
 		//forward declares
 		class Iterator;
 		class Const_Iterator;
@@ -22,143 +115,383 @@ namespace seq {
 		static constexpr std::size_t first_index = 0;
 	public:
 		//type names
-		using type            = Sequence<T>;
+		using type            = Sequence<T, Allocator, Growth>;
 		using value_type      = T;
+		using allocator_type  = Allocator;
+		using growth_type     = Growth;
 		using pointer         = T*;
 		using const_pointer   = const T*;
 		using reference       = T&;
 		using const_reference = const T&;
 		using size_type       = std::size_t;
 		using difference_type = std::ptrdiff_t;
+		using buffer_type     = SequenceBuffer<T>;
 
 		using iterator        = Iterator;
 		using const_iterator  = Const_Iterator;
 		//#################################################
 
 	private:
+		using alloc_traits    = std::allocator_traits<allocator_type>;
+
 		//the important shit
-		void tryReAllocate(size_type count) {
-			pointer moved = static_cast<pointer>(::operator new(count * sizeof(value_type)));
+		constexpr void tryReAllocate(size_type count, size_type required) {
+			[[maybe_unused]] auto timing = instrument.timeReallocation();
+			const size_type oldUnused = cap - mSize;
+			if constexpr (is_trivially_relocatable_v<value_type>) {
+				if (std::is_constant_evaluated())
+					tryReMove(count);
+				else
+					tryReLocate(count);
+			}
+			else {
+				tryReMove(count);
+			}
+			instrument.released(oldUnused * sizeof(value_type));
+			instrument.reallocated(mSize * sizeof(value_type), (cap - required) * sizeof(value_type));
+			growth.onReallocate(required, cap, sizeof(value_type));
+		}
+		constexpr void tryReMove(size_type count) {
+			pointer moved = memAlloc(count);
 			pointer initialized = moved;
 			pointer begin = raw_begin();
 			pointer end = raw_end();
 
 			try {
 				if constexpr (std::is_nothrow_move_constructible_v<value_type>) {
-					initialized = std::uninitialized_move(begin, end, moved);
+					initialized = detail::uninitialized_move(begin, end, moved);
 				}
 				else {
-					initialized = std::uninitialized_copy(begin, end, moved);
+					initialized = detail::uninitialized_copy(begin, end, moved);
 				}
 			}
 			catch (...) {
 				//this case should never happen but will only happen if T constructors themselves are faulty.
 				//i can't save you if your move semantis are declared noexcept but do actually hick up. in which case nothing is indeed thrown. the whole thing gets shut down
 				std::destroy(moved, initialized);
-				::operator delete(moved);
+				memDealloc(moved, count);
 				throw;
 			}
 
 			std::destroy(begin, end);
-			::operator delete(array);
+			memDealloc(array, cap);
 
 			array = moved;
-			cap = count;
+			cap = usableCapacity(moved, count);
 			//mSize unchanged
 		}
+		constexpr void tryReLocate(size_type count) {//relocatable types only, bytes move, nothing constructed or destroyed, nothing can throw past the allocation
+			assert(count >= mSize);
+			if constexpr (reallocating_allocator<allocator_type>) {
+				if (array) {
+					array = alloc.reallocate(array, cap, count);//throws and leaves the block untouched on failure
+					instrument.deallocated();
+					instrument.allocated(count * sizeof(value_type));
+					cap = usableCapacity(array, count);
+					return;
+				}
+			}
+			pointer moved = memAlloc(count);
+			if (mSize > 0)
+				std::memcpy(static_cast<void*>(moved), static_cast<const void*>(array), mSize * sizeof(value_type));
+			memDealloc(array, cap);
+
+			array = moved;
+			cap = usableCapacity(moved, count);
+		}
 		template <typename Construct>
-		void tryElemConstructAlloc(size_type count, Construct construct) {
-			pointer tempMem = static_cast<pointer>(::operator new(count * sizeof(value_type)));
+		constexpr void tryElemConstructAlloc(size_type count, Construct construct) {
+			pointer tempMem = memAlloc(count);
 			pointer initalizedTail = tempMem;
 
 			try {
 				initalizedTail = construct(tempMem, count);
+				instrument.constructed(count);
 				array = std::exchange(tempMem, nullptr);
 				mSize = count;
-				cap = count;
+				cap = usableCapacity(array, count);
 			}
 			catch (...) {
 				std::destroy(tempMem, initalizedTail);
-				::operator delete(tempMem);
+				memDealloc(tempMem, count);
 				throw;
 			}
 		}
 		//#################################################
 
 		//the convenience
-		void memFree()noexcept {
+		template <typename Construct>
+		constexpr void tryReAllocateInsert(size_type index, size_type count, Construct construct) {//new elements are built in the new block first, so construct may still read from the old one
+			[[maybe_unused]] auto timing = instrument.timeReallocation();
+			const size_type required = mSize + count;
+			const size_type newCap = growth.next(cap, required);
+			pointer moved = memAlloc(newCap);
+			pointer gapBegin = moved + index;
+			pointer gapEnd = gapBegin;
+
+			try {
+				gapEnd = construct(gapBegin);
+			}
+			catch (...) {
+				std::destroy(gapBegin, gapEnd);
+				memDealloc(moved, newCap);
+				throw;
+			}
+			instrument.constructed(count);
+			relocate(raw_begin(), raw_begin() + index, moved);
+			relocate(raw_begin() + index, raw_end(), gapEnd);
+			memDealloc(array, cap);
+			instrument.released((cap - mSize) * sizeof(value_type));
+			instrument.reallocated(mSize * sizeof(value_type), (usableCapacity(moved, newCap) - required) * sizeof(value_type));
+
+			array = moved;
+			mSize = required;
+			cap = usableCapacity(moved, newCap);
+			growth.onReallocate(required, cap, sizeof(value_type));
+		}
+		template <typename Construct>
+		constexpr void tryConstructBack(size_type count, Construct construct) {//construct count elements at the end, at most one reallocation
+			if (mSize + count > cap)
+				growTo(mSize + count);
+
+			pointer startAt = raw_end();
+			pointer ifFailurePosition = startAt;
+			try {
+				ifFailurePosition = construct(startAt);
+				instrument.constructed(count);
+				mSize += count;
+			}
+			catch (...) {
+				std::destroy(startAt, ifFailurePosition);
+				throw;
+			}
+		}
+		template <typename Construct>
+		constexpr iterator tryInsert(pointer pos, size_type count, Construct construct) {
+			const size_type index = pos - raw_begin();
+			if (count == 0)
+				return pos;
+			if (mSize + count > cap) {
+				tryReAllocateInsert(index, count, construct);
+				return raw_begin() + index;
+			}
+			if constexpr (std::is_trivially_copyable_v<value_type> && std::is_nothrow_invocable_v<Construct&, pointer>) {//open the gap with one memmove and fill it, construct can't throw into the half shifted tail
+				if (!std::is_constant_evaluated()) {
+					std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), (raw_end() - pos) * sizeof(value_type));
+					construct(pos);
+					instrument.constructed(count);
+					mSize += count;
+					return raw_begin() + index;
+				}
+			}
+			//build at the end where a throw is harmless, then rotate into place
+			pointer oldEnd = raw_end();
+			tryConstructBack(count, construct);
+			std::rotate(raw_begin() + index, oldEnd, raw_end());
+			return raw_begin() + index;
+		}
+		static constexpr void relocate(pointer first, pointer last, pointer dest)noexcept {//dest is uninitialized and doesn't overlap, source is left destroyed
+			if constexpr (is_trivially_relocatable_v<value_type>) {
+				if (!std::is_constant_evaluated()) {
+					if (first != last)
+						std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(value_type));
+					return;
+				}
+			}
+			detail::uninitialized_move(first, last, dest);
+			std::destroy(first, last);
+		}
+		template <typename It>
+		static constexpr bool copies_bitwise = std::is_trivially_copyable_v<value_type> && std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, value_type>;
+		template <std::forward_iterator It, std::sentinel_for<It> S>
+		static constexpr pointer copyInto(It first, S last, pointer dest)noexcept(copies_bitwise<It>) {
+			if constexpr (copies_bitwise<It>) {
+				if (!std::is_constant_evaluated()) {
+					const auto count = std::ranges::distance(first, last);
+					if (count > 0)
+						std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::to_address(first)), count * sizeof(value_type));
+					return dest + count;
+				}
+			}
+			return detail::uninitialized_copy(first, last, dest);
+		}
+		constexpr void validatePosition(const_pointer pos)const {
+			if (pos < array || pos > array + mSize) throw std::out_of_range("position out of range");
+		}
+		constexpr void growTo(size_type required) {
+			tryReAllocate(growth.next(cap, required), required);
+		}
+		constexpr size_type usableCapacity(pointer p, size_type count)const noexcept {
+			if constexpr (growth_type::use_usable_size && usable_size_allocator<allocator_type>) {
+				return std::max<size_type>(count, alloc.usable_size(p));
+			}
+			else {
+				return count;
+			}
+		}
+		constexpr pointer memAlloc(size_type count) {
+			pointer p = std::to_address(alloc_traits::allocate(alloc, count));
+			instrument.allocated(count * sizeof(value_type));
+			return p;
+		}
+		constexpr void memDealloc(pointer p, size_type count)noexcept {
+			if (p) {//unlike ::operator delete, allocators are not required to accept nullptr
+				alloc_traits::deallocate(alloc, p, count);
+				instrument.deallocated();
+			}
+		}
+		constexpr void memFree()noexcept {
 			if (array) {
-				::operator delete(array);
+				memDealloc(array, cap);
 				array = nullptr;
 				cap = 0;
 			}
 		}
-		void objDestroyAll()noexcept {
+		constexpr void releaseAll()noexcept {
+			if (array)
+				instrument.released((cap - mSize) * sizeof(value_type));
+			objDestroyAll();
+			memFree();
+		}
+		constexpr void stealFrom(Sequence& rhs)noexcept {//caller guarantees *this holds no memory and allocators are compatible
+			array = std::exchange(rhs.array, nullptr);
+			mSize = std::exchange(rhs.mSize, 0);
+			cap = std::exchange(rhs.cap, 0);
+		}
+		constexpr void swapAll(Sequence& rhs)noexcept {//swaps storage AND allocators, only for temporaries we built ourselves
+			using std::swap;
+			swap(alloc, rhs.alloc);
+			swapStorage(rhs);
+		}
+		constexpr void swapStorage(Sequence& rhs)noexcept {
+			pointer tempArr = array;
+			array = rhs.array;
+			rhs.array = tempArr;
+
+			size_type tempSize = mSize;
+			mSize = rhs.mSize;
+			rhs.mSize = tempSize;
+
+			size_type tempCap = cap;
+			cap = rhs.cap;
+			rhs.cap = tempCap;
+		}
+		constexpr void objDestroyAll()noexcept {
 			if (mSize > 0) {
 				std::destroy(raw_begin(), raw_end());
+				instrument.destroyed(mSize);
 				mSize = 0;
 			}
 		}
 		constexpr pointer raw_begin()                          { return array; }
 		constexpr pointer raw_end()                            { return array + mSize; }
-		constexpr size_type growthFactor(size_type input)const { return input + (input / 2) + 1; }
 		//#################################################
 	public:
 		//CONSTRUCTORS
-		constexpr Sequence()noexcept = default;
-		Sequence(size_type count) requires std::default_initializable<value_type> {
+		constexpr Sequence()noexcept(std::is_nothrow_default_constructible_v<allocator_type>) requires std::default_initializable<allocator_type> = default;
+		constexpr explicit Sequence(const allocator_type& allocator)noexcept :alloc(allocator) {}
+		constexpr Sequence(size_type count, const allocator_type& allocator = allocator_type()) requires std::default_initializable<value_type> :alloc(allocator) {
 			if (count == 0) return;
 			tryElemConstructAlloc(count, [](pointer p, size_type n) {
-				return std::uninitialized_value_construct_n(p, n);
+				return detail::uninitialized_value_construct_n(p, n);
 				}
 			);
 		}
-		Sequence(size_type count, const_reference value) requires std::copyable<value_type> {
+		constexpr Sequence(size_type count, const_reference value, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type> :alloc(allocator) {
 			if (count == 0)
 				return;
 			tryElemConstructAlloc(count, [&value](pointer p, size_type n) {
-				return std::uninitialized_fill_n(p, n, value);
+				return detail::uninitialized_fill_n(p, n, value);
 				}
 			);
 		}
-		Sequence(std::initializer_list<value_type> init) requires std::copyable<value_type> {
+		constexpr Sequence(std::initializer_list<value_type> init, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type> :alloc(allocator) {
 			if (init.size() == 0)
 				return;
 			tryElemConstructAlloc(init.size(), [init](pointer p, size_type n) {
-				return std::uninitialized_copy(init.begin(), init.end(), p);
+				return detail::uninitialized_copy(init.begin(), init.end(), p);
 				}
 			);
 		}
-		Sequence(const Sequence<value_type>& rhs) requires std::copyable<value_type> {
+		constexpr Sequence(const Sequence& rhs) requires std::copyable<value_type>
+			:Sequence(rhs, alloc_traits::select_on_container_copy_construction(rhs.alloc)) {}
+		constexpr Sequence(const Sequence& rhs, const allocator_type& allocator) requires std::copyable<value_type> :alloc(allocator) {
 			if (!rhs.isValid())
 				return;
 			tryElemConstructAlloc(rhs.size(), [&rhs](pointer p, size_type n) {
-				return std::uninitialized_copy(rhs.begin(), rhs.end(), p);
+				return detail::uninitialized_copy(rhs.begin(), rhs.end(), p);
 				}
 			);
 		}
-		constexpr Sequence(Sequence<value_type>&& rhs)noexcept {//shallow copy theft, no need for requirements
-			array = std::exchange(rhs.array, nullptr);
-			mSize = std::exchange(rhs.mSize, 0);
-			cap = std::exchange(rhs.cap, 0);
+		constexpr Sequence(Sequence&& rhs)noexcept :alloc(std::move(rhs.alloc)), growth(rhs.growth) {//shallow copy theft, no need for requirements
+			stealFrom(rhs);
+		}
+		constexpr Sequence(Sequence&& rhs, const allocator_type& allocator) requires strong_movable<value_type> :alloc(allocator) {
+			if (alloc == rhs.alloc) {
+				stealFrom(rhs);
+				return;
+			}
+			if (!rhs.isValid())
+				return;
+			//different memory source, the buffer can't be stolen so the elements have to walk over
+			tryElemConstructAlloc(rhs.size(), [&rhs](pointer p, size_type n) {
+				return detail::uninitialized_move(rhs.raw_begin(), rhs.raw_end(), p);
+				}
+			);
+		}
+		//takes the block over as is, nothing is copied. the inverse of release()
+		constexpr Sequence(adopt_buffer_t, buffer_type buffer, const allocator_type& allocator = allocator_type())noexcept
+			:alloc(allocator), array(buffer.data), mSize(buffer.size), cap(buffer.capacity) {
+			assert(buffer.size <= buffer.capacity && (buffer.data || buffer.capacity == 0));
+			if (array) {//to the stats the block arrives like a fresh allocation, so release() and adopt balance out
+				instrument.allocated(cap * sizeof(value_type));
+				instrument.constructed(mSize);
+			}
+		}
+		constexpr Sequence& operator=(const Sequence& rhs) requires std::copyable<value_type> {
+			if (this == &rhs)
+				return *this;
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				Sequence temp(rhs, rhs.alloc);
+				swapAll(temp);
+			}
+			else {
+				Sequence temp(rhs, alloc);
+				swapStorage(temp);
+			}
+			return *this;
 		}
-		Sequence& operator=(Sequence<value_type> rhs)noexcept {//AND THE LORD SAID LET THERE BE LIGHT
-			rhs.swap(*this);
+		constexpr Sequence& operator=(Sequence&& rhs)noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+			if (this == &rhs)
+				return *this;
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+				releaseAll();
+				if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+					alloc = std::move(rhs.alloc);
+				stealFrom(rhs);
+			}
+			else if (alloc == rhs.alloc) {
+				releaseAll();
+				stealFrom(rhs);
+			}
+			else {//AND THE LORD SAID LET THERE BE LIGHT, but in our own memory source
+				Sequence temp(std::move(rhs), alloc);
+				swapStorage(temp);
+			}
 			return *this;
 		}
-		Sequence& operator=(std::initializer_list<value_type> ilist) requires std::copyable<value_type> {
+		constexpr Sequence& operator=(std::initializer_list<value_type> ilist) requires std::copyable<value_type> {
 			if (ilist.size() == 0) {
 				objDestroyAll();
 				//memFree(); for the sake of future allocation, just don't free mem
 				return *this;
 			}
-			Sequence temp(ilist);
-			temp.swap(*this);
+			Sequence temp(ilist, alloc);
+			swapStorage(temp);
 			return *this;
 		}
-		~Sequence()noexcept {//putting a requirement here will cause a misleading error, noexcept is implict anyway but fuck it
-			objDestroyAll();
-			memFree();
+		constexpr ~Sequence()noexcept {//putting a requirement here will cause a misleading error, noexcept is implict anyway but fuck it
+			releaseAll();
 		}
 		//#################################################
 
@@ -206,29 +539,133 @@ namespace seq {
 		constexpr const_iterator end()const               { return { array + mSize }; }
 		constexpr const_iterator cbegin()const            { return { array }; }
 		constexpr const_iterator cend()const              { return { array + mSize }; }
+
+		//non-owning windows, see SequenceView.h. they see writes but die with the next reallocation
+		constexpr SequenceView<value_type>       view()noexcept        { return { array, mSize }; }
+		constexpr SequenceView<const value_type> view()const noexcept  { return { array, mSize }; }
+		constexpr SequenceView<value_type> slice(size_type offset, size_type count = SequenceView<value_type>::npos) {
+			return view().slice(offset, count);
+		}
+		constexpr SequenceView<const value_type> slice(size_type offset, size_type count = SequenceView<value_type>::npos)const {
+			return view().slice(offset, count);
+		}
+		//#################################################
+
+		//SEARCH, arithmetic value_type goes through the runtime dispatched kernels in Simd.h, everything else through the std algorithm
+		constexpr iterator find(const_reference value) requires std::equality_comparable<value_type> {
+			return { array + (std::as_const(*this).find(value) - cbegin()) };
+		}
+		constexpr const_iterator find(const_reference value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>) {
+				if (!std::is_constant_evaluated())
+					return { simd::find(array, array + mSize, value) };
+			}
+			return { std::find(array, array + mSize, value) };
+		}
+		constexpr size_type count(const_reference value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>) {
+				if (!std::is_constant_evaluated())
+					return simd::count(array, array + mSize, value);
+			}
+			return size_type(std::count(array, array + mSize, value));
+		}
+		constexpr bool contains(const_reference value)const requires std::equality_comparable<value_type> {
+			return find(value) != cend();
+		}
+		constexpr std::ranges::min_max_result<value_type> min_max()const requires std::is_arithmetic_v<value_type> {
+			assert(mSize > first_index);
+			if (std::is_constant_evaluated()) {
+				const auto [lo, hi] = std::minmax_element(array, array + mSize);
+				return { *lo, *hi };
+			}
+			return simd::min_max(array, array + mSize);
+		}
+		constexpr simd::sum_t<value_type> sum()const requires std::is_arithmetic_v<value_type> {
+			if (std::is_constant_evaluated()) {
+				simd::sum_t<value_type> total = 0;
+				for (size_type i = 0; i < mSize; i++)
+					total += array[i];
+				return total;
+			}
+			return simd::sum(array, array + mSize);
+		}
 		//#################################################
 
 		//MODIFICATION
 		template <typename U>
-		void push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {//implicit copy or move requirement
+		constexpr void push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {//implicit copy or move requirement
 			if (mSize == cap)
-				tryReAllocate(growthFactor(cap));
+				growTo(mSize + 1);
 			std::construct_at(raw_end(), std::forward<U>(value));
+			instrument.constructed(1);
 			++mSize;
 		}
-		template<typename... Args> void emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+		template<typename... Args> constexpr void emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
 			if (mSize == cap)
-				tryReAllocate(growthFactor(cap));
+				growTo(mSize + 1);
 			std::construct_at(raw_end(), std::forward<Args>(args)...);//safe to throw on fail, array not modified
+			instrument.constructed(1);
 			++mSize;
 		}
-		void pop_back()noexcept {
+		template <std::ranges::input_range Range>
+		constexpr void append_range(Range&& range) requires std::constructible_from<value_type, std::ranges::range_reference_t<Range>> && strong_movable<value_type> {
+			if constexpr (std::ranges::forward_range<Range>) {
+				const size_type count = static_cast<size_type>(std::ranges::distance(range));
+				tryConstructBack(count, [&range](pointer p) {
+					return copyInto(std::ranges::begin(range), std::ranges::end(range), p);
+					}
+				);
+			}
+			else {//single pass, size unknown up front
+				for (auto&& elem : range)
+					emplace_back(std::forward<decltype(elem)>(elem));
+			}
+		}
+		template <std::input_iterator It, std::sentinel_for<It> S>
+		constexpr iterator insert(const_iterator pos, It first, S last) requires std::constructible_from<value_type, std::iter_reference_t<It>> && strong_movable<value_type> {
+			validatePosition(pos.base());
+			pointer at = array + (pos.base() - array);
+			if constexpr (std::forward_iterator<It>) {
+				const size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+				return tryInsert(at, count, [&first, &last](pointer p)noexcept(copies_bitwise<It>) {
+					return copyInto(first, last, p);
+					}
+				);
+			}
+			else {
+				const size_type index = at - raw_begin();
+				const size_type oldSize = mSize;
+				for (; first != last; ++first)
+					emplace_back(*first);
+				std::rotate(raw_begin() + index, raw_begin() + oldSize, raw_end());
+				return raw_begin() + index;
+			}
+		}
+		constexpr iterator insert(const_iterator pos, size_type count, const_reference value) requires std::copyable<value_type> && strong_movable<value_type> {
+			validatePosition(pos.base());
+			pointer at = array + (pos.base() - array);
+			if constexpr (std::is_trivially_copyable_v<value_type>) {
+				const value_type copy = value;//value may live inside the range the memmove shifts
+				return tryInsert(at, count, [&copy, count](pointer p)noexcept {
+					return detail::uninitialized_fill_n(p, count, copy);
+					}
+				);
+			}
+			else {
+				return tryInsert(at, count, [&value, count](pointer p) {
+					return detail::uninitialized_fill_n(p, count, value);
+					}
+				);
+			}
+		}
+		constexpr void pop_back()noexcept {
 			if (mSize > 0) {
 				std::destroy_at(raw_end() - 1);
+				instrument.destroyed(1);
 				--mSize;
 			}
 		}
-		iterator erase(iterator pos)requires strong_movable<value_type> {
+		constexpr iterator erase(iterator pos)requires strong_movable<value_type> {
 			pointer eraseElem = pos.base();
 			pointer arrayBegin = raw_begin();
 			pointer arrayEnd = raw_end();
@@ -238,11 +675,12 @@ namespace seq {
 			std::move(eraseElem + 1, arrayEnd, eraseElem);//from -> till -> destination == eraseElem gets overwriten then destroyed
 			--arrayEnd;//last valid element
 			std::destroy_at(arrayEnd);//destroy the last valid element, oldEnd is now one off the end
+			instrument.destroyed(1);
 			--mSize;
 
 			return (eraseElem == raw_end()) ? raw_end() : eraseElem;
 		}
-		iterator erase(iterator first, iterator last)requires strong_movable<value_type> {
+		constexpr iterator erase(iterator first, iterator last)requires strong_movable<value_type> {
 			pointer eraseFirst = first.base();
 			pointer eraseLast = last.base();
 			pointer arrayBegin = raw_begin();
@@ -253,6 +691,7 @@ namespace seq {
 
 			if (eraseLast == arrayEnd) {//if last is end, then it means we can simply erase the tail end
 				std::destroy(eraseFirst, eraseLast);
+				instrument.destroyed(eraseLast - eraseFirst);
 				mSize = eraseFirst - arrayBegin;
 				return raw_end();
 			}
@@ -261,11 +700,12 @@ namespace seq {
 			//math: size 25: destroy elem 5 to 10:: 5+(25-10) = 20, destroy 20 to 25. then mSize-=(25-20), reduce by 5
 			pointer destroyBegin = eraseFirst + (arrayEnd - eraseLast);
 			std::destroy(destroyBegin, arrayEnd);//remove the dangling tail end
+			instrument.destroyed(arrayEnd - destroyBegin);
 			mSize -= (arrayEnd - destroyBegin);
 
 			return eraseFirst;
 		}
-		iterator remove(iterator pos)requires strong_movable<value_type> {
+		constexpr iterator remove(iterator pos)requires strong_movable<value_type> {
 			pointer removeElem = pos.base();
 			pointer arrayBegin = raw_begin();
 			pointer arrayEnd = raw_end();
@@ -276,11 +716,12 @@ namespace seq {
 			--arrayEnd;
 			*removeElem = std::move(*arrayEnd);//slightly less op than swap
 			std::destroy_at(arrayEnd);
+			instrument.destroyed(1);
 			--mSize;
 			return (removeElem == arrayEnd) ? arrayEnd : removeElem;
 		}
 		template <typename UnaryPred>
-		iterator remove(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred, const_reference> {
+		constexpr iterator remove(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred, const_reference> {
 
 			pointer arrayBegin = raw_begin();
 			pointer arrayEnd = raw_end();
@@ -302,24 +743,51 @@ namespace seq {
 
 			if (newSize < size()) {
 				std::destroy(realOnePastEnd, arrayEnd);
+				instrument.destroyed(size() - newSize);
 				mSize = newSize;
 			}
 
 			return realOnePastEnd;
 		}
-
+		//order preserving counterpart of remove(predicate): one compaction pass, the dead tail is destroyed once. returns how many went
+		template <typename UnaryPred>
+		constexpr size_type erase_if(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred&, const_reference> {
+			pointer newEnd;
+			if constexpr (std::is_arithmetic_v<value_type>)//one remove_if per instantiation, small enough to inline where pred is known
+				newEnd = std::is_constant_evaluated() ? std::remove_if(raw_begin(), raw_end(), predicate) : simd::compact(raw_begin(), raw_end(), predicate);
+			else
+				newEnd = std::remove_if(raw_begin(), raw_end(), predicate);
+			const size_type removed = raw_end() - newEnd;
+			std::destroy(newEnd, raw_end());
+			instrument.destroyed(removed);
+			mSize -= removed;
+			return removed;
+		}
+
+		//hands the whole block out without moving an element, this ends empty. the caller now owns the elements and the memory:
+		//destroy and deallocate with an equal allocator, or give it to another Sequence through the adopt_buffer constructor
+		[[nodiscard]] constexpr buffer_type release()noexcept {
+			if (array) {
+				instrument.released((cap - mSize) * sizeof(value_type));
+				instrument.destroyed(mSize);
+				instrument.deallocated();
+			}
+			return { std::exchange(array, nullptr), std::exchange(mSize, 0), std::exchange(cap, 0) };
+		}
+		//same hand off as an owning Sequence, allocator and growth state go along
+		[[nodiscard]] constexpr Sequence take()noexcept {
+			return Sequence(std::move(*this));
+		}
 		constexpr void swap(Sequence& rhs)noexcept {
-			pointer tempArr = array;
-			array = rhs.array;
-			rhs.array = tempArr;
-
-			size_type tempSize = mSize;
-			mSize = rhs.mSize;
-			rhs.mSize = tempSize;
-
-			size_type tempCap = cap;
-			cap = rhs.cap;
-			rhs.cap = tempCap;
+			using std::swap;
+			if constexpr (alloc_traits::propagate_on_container_swap::value) {
+				swapAll(rhs);
+			}
+			else {
+				assert(alloc == rhs.alloc && "swapping Sequences with unequal non-propagating allocators is undefined");
+				swapStorage(rhs);
+			}
+			swap(growth, rhs.growth);
 		}
 		//#################################################
 
@@ -329,18 +797,25 @@ namespace seq {
 		constexpr bool      isValid()const noexcept  { return array; }
 		constexpr size_type size()const noexcept     { return mSize; }
 		constexpr size_type capacity()const noexcept { return cap; }
+		constexpr size_type max_size()const noexcept {
+			return std::min<size_type>(alloc_traits::max_size(alloc), size_type(std::numeric_limits<difference_type>::max()) / sizeof(value_type));
+		}
+		constexpr allocator_type get_allocator()const noexcept { return alloc; }
+		constexpr const growth_type& growth_policy()const noexcept { return growth; }
+		constexpr void tagStats(std::string_view name) { instrument.tag(name); }//SEQ_STATS builds: report to the named entry instead of the type's
 
-		void resize_shrink(size_type count)noexcept {
+		constexpr void resize_shrink(size_type count)noexcept {
 			if (count >= mSize) return;//when shrinking if count is more, simply no OP
 
 			std::destroy(raw_begin() + count, raw_end());
+			instrument.destroyed(mSize - count);
 			mSize = count;
 		}
-		void resize_grow(size_type count)requires std::default_initializable<value_type> && strong_movable<value_type> {
+		constexpr void resize_grow(size_type count)requires std::default_initializable<value_type> && strong_movable<value_type> {
 			if (count <= mSize) return;//if count is less than current size, then logically no grow no op
 
 			if (count > cap) {
-				tryReAllocate(growthFactor(count));
+				growTo(count);
 			}
 
 			pointer startAt = raw_end();
@@ -348,7 +823,8 @@ namespace seq {
 			size_type amount = count - mSize;
 
 			try {
-				ifFailurePosition = std::uninitialized_value_construct_n(startAt, amount);
+				ifFailurePosition = detail::uninitialized_value_construct_n(startAt, amount);
+				instrument.constructed(amount);
 				mSize = count;
 			}
 			catch (...) {
@@ -356,67 +832,88 @@ namespace seq {
 				throw;
 			}
 		}
-		void reserve(size_type newCap) requires strong_movable<value_type> {
+		//default-initializes instead of value-initializing, for trivial T the new elements hold garbage until written through data()
+		constexpr void resize_for_overwrite(size_type count)requires std::default_initializable<value_type> && strong_movable<value_type> {
+			if (count <= mSize) return;
+			append_uninitialized(count - mSize);
+		}
+		constexpr pointer append_uninitialized(size_type count)requires std::default_initializable<value_type> && strong_movable<value_type> {
+			tryConstructBack(count, [count](pointer p) {
+				return detail::uninitialized_default_construct_n(p, count);
+				}
+			);
+			return raw_end() - count;
+		}
+		constexpr void reserve(size_type newCap) requires strong_movable<value_type> {
 			if (newCap > cap) {
-				tryReAllocate(newCap);
+				tryReAllocate(newCap, newCap);
 			}
 		}
-		void shrinkToFit() requires strong_movable<value_type> {
+		constexpr void shrinkToFit() requires strong_movable<value_type> {
 			if (cap > mSize) {
-				tryReAllocate(size());
+				tryReAllocate(size(), size());
 			}
 		}
-		void clear() noexcept {
+		constexpr void clear() noexcept {
 			objDestroyAll();
 		}
 		//#################################################
 	private:
 		//members
+		SEQ_NO_UNIQUE_ADDRESS allocator_type alloc;
+		SEQ_NO_UNIQUE_ADDRESS growth_type growth;
+		SEQ_NO_UNIQUE_ADDRESS stats::BasicSink<Sequence> instrument;
 		pointer array = nullptr;
 		size_type mSize = 0;
 		size_type cap = 0;
 	};
 
-	template <typename SequenceType>
-	constexpr bool operator==(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
-		if (lhs.size != rhs.size) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator==(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
+		if (lhs.size() != rhs.size()) {
 			return false;
 		}
+		if constexpr (std::is_arithmetic_v<SequenceType>) {
+			if (!std::is_constant_evaluated())
+				return simd::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+		}
 		return std::equal(lhs.begin(), lhs.end(), rhs.begin());
 	}
-	template <typename SequenceType>
-	constexpr bool operator!=(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator!=(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
 		return !(lhs == rhs);
 	}
-	template <typename SequenceType>
-	constexpr bool operator<(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator<(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
 		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 	}
-	template <typename SequenceType>
-	constexpr bool operator>(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator>(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
 		return rhs < lhs;
 	}
-	template <typename SequenceType>
-	constexpr bool operator<=(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator<=(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
 		return !(rhs < lhs);
 	}
-	template <typename SequenceType>
-	constexpr bool operator>=(const Sequence<SequenceType>& lhs, const Sequence<SequenceType>& rhs) {
+	template <typename SequenceType, typename Allocator, typename Growth>
+	constexpr bool operator>=(const Sequence<SequenceType, Allocator, Growth>& lhs, const Sequence<SequenceType, Allocator, Growth>& rhs) {
 		return !(lhs < rhs);
 	}
 
-	template<typename SequenceType>
-	constexpr void swap(Sequence<SequenceType>& lhs, Sequence<SequenceType>& rhs)noexcept {
+	template<typename SequenceType, typename Allocator, typename Growth>
+	constexpr void swap(Sequence<SequenceType, Allocator, Growth>& lhs, Sequence<SequenceType, Allocator, Growth>& rhs)noexcept {
 		lhs.swap(rhs);
 	}
 
-	template<typename T>
-	class Sequence<T>::Iterator {
+	template<typename T, typename Allocator, typename Growth>
+	class Sequence<T, Allocator, Growth>::Iterator {
 	public:
 		using value_type = T;
+		using element_type = T;
 		using pointer = T*;
 		using reference = T&;
 		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::contiguous_iterator_tag;
 		using difference_type = std::ptrdiff_t;
 		using self_type = Iterator;
 
@@ -437,23 +934,27 @@ namespace seq {
 		constexpr self_type operator+(difference_type n)const noexcept { return self_type(ptr + n); }
 		constexpr self_type operator-(difference_type n)const noexcept { return self_type(ptr - n); }
 		constexpr difference_type operator-(const self_type& rhs)const noexcept { return ptr - rhs.ptr; }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
 
 		constexpr bool operator==(const self_type& rhs)const noexcept { return ptr == rhs.ptr; }
 		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return ptr <=> rhs.ptr; }
 
-		constexpr Iterator(pointer p) :ptr(p) { assert(p != nullptr && "Iterator constructed from nullptr!"); }
+		constexpr Iterator()noexcept = default;//singular, only so the std iterator concepts are satisfied
+		constexpr Iterator(pointer p) :ptr(p) {}//null is fine, it's what begin()/end() of an empty Sequence are
 		constexpr pointer base()const noexcept { return ptr; }
 	private:
 		pointer ptr = nullptr;
 	};
 
-	template<typename T>
-	class Sequence<T>::Const_Iterator {
+	template<typename T, typename Allocator, typename Growth>
+	class Sequence<T, Allocator, Growth>::Const_Iterator {
 	public:
 		using value_type = const T;
+		using element_type = const T;
 		using pointer = const T*;
 		using reference = const T&;
 		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::contiguous_iterator_tag;
 		using difference_type = std::ptrdiff_t;
 		using self_type = Const_Iterator;
 
@@ -471,14 +972,21 @@ namespace seq {
 		constexpr self_type operator+(difference_type n)const noexcept { return self_type(ptr + n); }
 		constexpr self_type operator-(difference_type n)const noexcept { return self_type(ptr - n); }
 		constexpr difference_type operator-(const self_type& rhs)const noexcept { return ptr - rhs.ptr; }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
 
 		constexpr bool operator==(const self_type& rhs)const noexcept { return ptr == rhs.ptr; }
 		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return ptr <=> rhs.ptr; }
 
-		constexpr Const_Iterator(pointer p) :ptr(p) { assert(ptr != nullptr && "Iterator constructed from nullptr!"); }
-		constexpr Const_Iterator(const Iterator& rp) : ptr(rp.base()) { assert(ptr != nullptr && "Iterator constructed from nullptr!"); }
+		constexpr Const_Iterator()noexcept = default;
+		constexpr Const_Iterator(pointer p) :ptr(p) {}
+		constexpr Const_Iterator(const Iterator& rp) : ptr(rp.base()) {}
 		constexpr pointer base()const noexcept { return ptr; }
 	private:
 		pointer ptr = nullptr;
 	};
+
+	namespace pmr {
+		template <typename T>
+		using Sequence = seq::Sequence<T, std::pmr::polymorphic_allocator<T>>;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <assert.h>
+#include <stdexcept>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <algorithm>
+#include "Simd.h"
+
+namespace seq {
+	//forward declares
+	template <typename T>
+	class StridedView;
+	template <typename T>
+	class ChunkView;
+
+	namespace detail {
+		template <typename Range, typename T>
+		concept viewable_as = std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>
+			&& std::convertible_to<std::remove_reference_t<std::ranges::range_reference_t<Range>>(*)[], T(*)[]>//same element, at most adds const
+			&& (std::ranges::borrowed_range<Range> || std::is_const_v<T>);//a temporary container would die under a mutable view
+	}
+
+	//non-owning window over contiguous elements: a pointer and a count, copied by value, never allocates.
+	//T may be const for read only access. made from a Sequence (view()/slice()), any contiguous sized range or a std::span, and
+	//converts back to a std::span. it dies with the storage it points into, any reallocation of the owner invalidates it
+	template <typename T>
+	class SequenceView {
+	private:
+		static_assert(std::is_object_v<T>, "T must be an object type");
+
+		static constexpr std::size_t first_index = 0;
+
+	public:
+		//type names
+		using type            = SequenceView<T>;
+		using element_type    = T;
+		using value_type      = std::remove_cv_t<T>;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = T*;
+		using const_iterator  = const T*;
+
+		static constexpr size_type npos = size_type(-1);
+		//#################################################
+
+		//CONSTRUCTORS
+		constexpr SequenceView()noexcept = default;
+		constexpr SequenceView(pointer first, size_type count)noexcept :array(first), mSize(count) {
+			assert(first || count == 0);
+		}
+		constexpr SequenceView(pointer first, pointer last)noexcept :array(first), mSize(size_type(last - first)) {
+			assert(first <= last);
+		}
+		template <typename Range> requires (!std::same_as<std::remove_cvref_t<Range>, SequenceView> && detail::viewable_as<Range, T>)
+		constexpr SequenceView(Range&& range)noexcept(noexcept(std::ranges::data(range)))
+			:array(std::ranges::data(range)), mSize(std::ranges::size(range)) {}
+		//#################################################
+
+		//ACCESS
+		constexpr reference front()const {
+			assert(mSize > first_index);
+			return array[first_index];
+		}
+		constexpr reference back()const {
+			assert(mSize > first_index);
+			return array[mSize - 1];
+		}
+		constexpr reference operator[](size_type index)const {
+			assert(index < mSize);
+			return array[index];
+		}
+		constexpr reference at(size_type pos)const {
+			if (pos >= mSize)
+				throw std::out_of_range("position out of range");
+			return array[pos];
+		}
+		constexpr pointer  data()const noexcept  { return array; }
+		constexpr iterator begin()const noexcept { return array; }
+		constexpr iterator end()const noexcept   { return array + mSize; }
+
+		constexpr std::span<T> span()const noexcept { return { array, mSize }; }
+		template <typename U> requires std::convertible_to<T(*)[], U(*)[]>
+		constexpr operator std::span<U>()const noexcept { return { array, mSize }; }
+		//#################################################
+
+		//SLICING, all O(1) and none of them copy an element
+		//count elements from offset, clamped to what is left like std::string::substr. offset past the end throws
+		constexpr SequenceView slice(size_type offset, size_type count = npos)const {
+			if (offset > mSize)
+				throw std::out_of_range("slice offset out of range");
+			return { array + offset, std::min(count, mSize - offset) };
+		}
+		constexpr SequenceView first(size_type count)const {
+			assert(count <= mSize);
+			return { array, count };
+		}
+		constexpr SequenceView last(size_type count)const {
+			assert(count <= mSize);
+			return { array + (mSize - count), count };
+		}
+		constexpr SequenceView drop(size_type count)const {
+			assert(count <= mSize);
+			return { array + count, mSize - count };
+		}
+		//every step'th element starting with the first
+		constexpr StridedView<T> strided(size_type step)const {
+			return { array, mSize, step };
+		}
+		//consecutive windows of count elements, the last one holds the remainder
+		constexpr ChunkView<T> chunks(size_type count)const {
+			return { array, mSize, count };
+		}
+		//#################################################
+
+		//SEARCH, same dispatch as Sequence: arithmetic value_type through the Simd.h kernels, the rest through the std algorithm
+		iterator find(const value_type& value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>)
+				return array + (simd::find<value_type>(array, array + mSize, value) - array);
+			else
+				return std::find(array, array + mSize, value);
+		}
+		size_type count(const value_type& value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>)
+				return simd::count<value_type>(array, array + mSize, value);
+			else
+				return size_type(std::count(array, array + mSize, value));
+		}
+		bool contains(const value_type& value)const requires std::equality_comparable<value_type> {
+			return find(value) != end();
+		}
+		std::ranges::min_max_result<value_type> min_max()const requires std::is_arithmetic_v<value_type> {
+			assert(mSize > first_index);
+			return simd::min_max<value_type>(array, array + mSize);
+		}
+		simd::sum_t<value_type> sum()const requires std::is_arithmetic_v<value_type> {
+			return simd::sum<value_type>(array, array + mSize);
+		}
+		//#################################################
+
+		//CAPACITY
+		constexpr bool      isEmpty()const noexcept    { return mSize == 0; }
+		constexpr size_type size()const noexcept       { return mSize; }
+		constexpr size_type size_bytes()const noexcept { return mSize * sizeof(T); }
+		//#################################################
+	private:
+		//members
+		pointer array = nullptr;
+		size_type mSize = 0;
+	};
+
+	template <std::ranges::contiguous_range Range> requires std::ranges::sized_range<Range>
+	SequenceView(Range&&) -> SequenceView<std::remove_reference_t<std::ranges::range_reference_t<Range>>>;
+	template <typename T>
+	SequenceView(T*, std::size_t) -> SequenceView<T>;
+	template <typename T>
+	SequenceView(T*, T*) -> SequenceView<T>;
+
+	template <typename T, typename U> requires std::equality_comparable_with<const T&, const U&>
+	constexpr bool operator==(SequenceView<T> lhs, SequenceView<U> rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+		if constexpr (std::is_arithmetic_v<std::remove_cv_t<T>> && std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<U>>) {
+			if (!std::is_constant_evaluated())
+				return simd::equal<std::remove_cv_t<T>>(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+		}
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	//every step'th element of a contiguous window. the iterator carries an index, not a pointer, so the end position never
+	//points past the storage when size isn't a multiple of step
+	template <typename T>
+	class StridedView {
+	private:
+		class Iterator;
+	public:
+		//type names
+		using type            = StridedView<T>;
+		using element_type    = T;
+		using value_type      = std::remove_cv_t<T>;
+		using pointer         = T*;
+		using reference       = T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = Iterator;
+		using const_iterator  = Iterator;
+		//#################################################
+
+		//CONSTRUCTORS
+		constexpr StridedView()noexcept = default;
+		constexpr StridedView(pointer first, size_type count, size_type step)noexcept
+			:array(first), mSize(step ? (count + step - 1) / step : 0), step(step) {
+			assert(step > 0);
+		}
+		//#################################################
+
+		//ACCESS
+		constexpr reference front()const {
+			assert(mSize > 0);
+			return array[0];
+		}
+		constexpr reference back()const {
+			assert(mSize > 0);
+			return array[(mSize - 1) * step];
+		}
+		constexpr reference operator[](size_type index)const {
+			assert(index < mSize);
+			return array[index * step];
+		}
+		constexpr reference at(size_type pos)const {
+			if (pos >= mSize)
+				throw std::out_of_range("position out of range");
+			return array[pos * step];
+		}
+		constexpr iterator begin()const noexcept { return { array, step, 0 }; }
+		constexpr iterator end()const noexcept   { return { array, step, difference_type(mSize) }; }
+		constexpr size_type stride()const noexcept { return step; }
+		//#################################################
+
+		//CAPACITY
+		constexpr bool      isEmpty()const noexcept { return mSize == 0; }
+		constexpr size_type size()const noexcept    { return mSize; }
+		//#################################################
+	private:
+		//members
+		pointer array = nullptr;
+		size_type mSize = 0;
+		size_type step = 1;
+	};
+
+	template <typename T>
+	class StridedView<T>::Iterator {
+	public:
+		using value_type = std::remove_cv_t<T>;
+		using pointer = T*;
+		using reference = T&;
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using self_type = Iterator;
+
+		constexpr reference operator*()const noexcept { return base[index * step]; }
+		constexpr pointer operator->()const noexcept { return base + index * step; }
+		constexpr reference operator[](difference_type n)const noexcept { return base[(index + n) * step]; }
+
+		constexpr self_type& operator++()noexcept { ++index; return *this; }
+		constexpr self_type operator++(int)noexcept { self_type temp = *this; ++index; return temp; }
+		constexpr self_type& operator--()noexcept { --index; return *this; }
+		constexpr self_type operator--(int)noexcept { self_type temp = *this; --index; return temp; }
+
+		constexpr self_type& operator+=(difference_type n)noexcept { index += n; return *this; }
+		constexpr self_type& operator-=(difference_type n)noexcept { index -= n; return *this; }
+		constexpr self_type operator+(difference_type n)const noexcept { return { base, size_type(step), index + n }; }
+		constexpr self_type operator-(difference_type n)const noexcept { return { base, size_type(step), index - n }; }
+		constexpr difference_type operator-(const self_type& rhs)const noexcept { return index - rhs.index; }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
+
+		constexpr bool operator==(const self_type& rhs)const noexcept { return index == rhs.index; }
+		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return index <=> rhs.index; }
+
+		constexpr Iterator()noexcept = default;
+		constexpr Iterator(pointer base, size_type step, difference_type index)noexcept :base(base), step(difference_type(step)), index(index) {}
+	private:
+		pointer base = nullptr;
+		difference_type step = 1;
+		difference_type index = 0;
+	};
+
+	//consecutive SequenceViews of a fixed count over a contiguous window, the last one shorter when it doesn't divide evenly.
+	//the handy shape for handing batches to workers or a stage that wants fixed size blocks
+	template <typename T>
+	class ChunkView {
+	private:
+		class Iterator;
+	public:
+		//type names
+		using type            = ChunkView<T>;
+		using value_type      = SequenceView<T>;
+		using reference       = SequenceView<T>;
+		using pointer         = T*;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = Iterator;
+		using const_iterator  = Iterator;
+		//#################################################
+
+		//CONSTRUCTORS
+		constexpr ChunkView()noexcept = default;
+		constexpr ChunkView(pointer first, size_type count, size_type chunk)noexcept :array(first), total(count), chunk(chunk) {
+			assert(chunk > 0);
+		}
+		//#################################################
+
+		//ACCESS
+		constexpr reference operator[](size_type index)const {
+			assert(index < size());
+			const size_type offset = index * chunk;
+			return { array + offset, std::min(chunk, total - offset) };
+		}
+		constexpr reference front()const { return (*this)[0]; }
+		constexpr reference back()const  { return (*this)[size() - 1]; }
+		constexpr iterator begin()const noexcept { return { array, total, chunk, 0 }; }
+		constexpr iterator end()const noexcept   { return { array, total, chunk, difference_type(size()) }; }
+		constexpr size_type chunk_size()const noexcept { return chunk; }
+		//#################################################
+
+		//CAPACITY
+		constexpr bool      isEmpty()const noexcept { return total == 0; }
+		constexpr size_type size()const noexcept    { return chunk ? (total + chunk - 1) / chunk : 0; }
+		//#################################################
+	private:
+		//members
+		pointer array = nullptr;
+		size_type total = 0;
+		size_type chunk = 1;
+	};
+
+	template <typename T>
+	class ChunkView<T>::Iterator {//yields views by value, so it is a C++20 random access iterator but only an input iterator to old code
+	public:
+		using value_type = SequenceView<T>;
+		using reference = SequenceView<T>;
+		using iterator_category = std::input_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using self_type = Iterator;
+
+		constexpr reference operator*()const noexcept { return (*this)[0]; }
+		constexpr reference operator[](difference_type n)const noexcept {
+			const size_type offset = size_type(index + n) * chunk;
+			return { array + offset, std::min(chunk, total - offset) };
+		}
+
+		constexpr self_type& operator++()noexcept { ++index; return *this; }
+		constexpr self_type operator++(int)noexcept { self_type temp = *this; ++index; return temp; }
+		constexpr self_type& operator--()noexcept { --index; return *this; }
+		constexpr self_type operator--(int)noexcept { self_type temp = *this; --index; return temp; }
+
+		constexpr self_type& operator+=(difference_type n)noexcept { index += n; return *this; }
+		constexpr self_type& operator-=(difference_type n)noexcept { index -= n; return *this; }
+		constexpr self_type operator+(difference_type n)const noexcept { return { array, total, chunk, index + n }; }
+		constexpr self_type operator-(difference_type n)const noexcept { return { array, total, chunk, index - n }; }
+		constexpr difference_type operator-(const self_type& rhs)const noexcept { return index - rhs.index; }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
+
+		constexpr bool operator==(const self_type& rhs)const noexcept { return index == rhs.index; }
+		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return index <=> rhs.index; }
+
+		constexpr Iterator()noexcept = default;
+		constexpr Iterator(pointer array, size_type total, size_type chunk, difference_type index)noexcept
+			:array(array), total(total), chunk(chunk), index(index) {}
+	private:
+		pointer array = nullptr;
+		size_type total = 0;
+		size_type chunk = 1;
+		difference_type index = 0;
+	};
+}
+
+//all three only point into storage they don't own, so they are views and iterators taken from a temporary one stay valid
+namespace std::ranges {
+	template <typename T>
+	inline constexpr bool enable_borrowed_range<seq::SequenceView<T>> = true;
+	template <typename T>
+	inline constexpr bool enable_view<seq::SequenceView<T>> = true;
+	template <typename T>
+	inline constexpr bool enable_borrowed_range<seq::StridedView<T>> = true;
+	template <typename T>
+	inline constexpr bool enable_view<seq::StridedView<T>> = true;
+	template <typename T>
+	inline constexpr bool enable_borrowed_range<seq::ChunkView<T>> = true;
+	template <typename T>
+	inline constexpr bool enable_view<seq::ChunkView<T>> = true;
+}
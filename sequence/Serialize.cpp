@@ -0,0 +1,396 @@
+#include "Serialize.h"
+#include <bit>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <system_error>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace seq::io {
+	namespace {
+		constexpr char magic[4] = { 'S', 'E', 'Q', 'B' };
+		constexpr std::uint32_t byte_order_mark = 0x01020304;//reads back as 0x04030201 on the other byte order
+
+		template <typename T>
+		void store(std::byte* out, std::size_t offset, T value)noexcept {
+			std::memcpy(out + offset, &value, sizeof(T));
+		}
+		template <typename T>
+		T fetch(const std::byte* in, std::size_t offset)noexcept {
+			T value;
+			std::memcpy(&value, in + offset, sizeof(T));
+			return value;
+		}
+
+		//xxh64 primes and rounds
+		constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+		constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+		constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+		inline std::uint64_t round(std::uint64_t acc, std::uint64_t input)noexcept {
+			acc += input * prime2;
+			acc = std::rotl(acc, 31);
+			return acc * prime1;
+		}
+		inline std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t lane)noexcept {
+			acc ^= round(0, lane);
+			return acc * prime1 + prime4;
+		}
+		inline void stripe(std::uint64_t* lanes, const std::byte* block)noexcept {
+			for (int i = 0; i < 4; i++)
+				lanes[i] = round(lanes[i], fetch<std::uint64_t>(block, i * 8));
+		}
+
+		[[noreturn]] void throwLastError(const char* what) {
+#if defined(_WIN32)
+			throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+#else
+			throw std::system_error(errno, std::system_category(), what);
+#endif
+		}
+	}
+
+	void Header::encode(std::byte* out)const noexcept {
+		std::memcpy(out, magic, sizeof(magic));
+		store(out, 4, version);
+		store(out, 6, flags);
+		store(out, 8, byte_order_mark);
+		store(out, 12, elemSize);
+		store(out, 16, elemAlign);
+		store(out, 20, std::uint32_t(0));//reserved, keeps the 64 bit fields aligned
+		store(out, 24, count);
+		store(out, 32, checksum);
+	}
+
+	Header Header::decode(const std::byte* in) {
+		if (std::memcmp(in, magic, sizeof(magic)) != 0)
+			throw FormatError("seq::io: not a Sequence file");
+		if (fetch<std::uint32_t>(in, 8) != byte_order_mark)
+			throw FormatError("seq::io: written on a machine of the other byte order");
+		Header header;
+		header.version = fetch<std::uint16_t>(in, 4);
+		if (header.version != format_version)
+			throw FormatError("seq::io: unsupported format version");
+		header.flags = fetch<std::uint16_t>(in, 6);
+		if (header.flags != raw && header.flags != chunked)
+			throw FormatError("seq::io: unknown payload encoding");
+		header.elemSize = fetch<std::uint32_t>(in, 12);
+		header.elemAlign = fetch<std::uint32_t>(in, 16);
+		header.count = fetch<std::uint64_t>(in, 24);
+		header.checksum = fetch<std::uint64_t>(in, 32);
+		return header;
+	}
+	//#################################################
+
+	Checksum::Checksum(std::uint64_t seed)noexcept
+		:lanes{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 }, seed(seed) {}
+
+	void Checksum::update(const void* data, std::size_t bytes)noexcept {
+		const std::byte* p = static_cast<const std::byte*>(data);
+		total += bytes;
+		if (pendingBytes > 0) {//top up a stripe left over from the last call first
+			const std::size_t take = std::min(bytes, sizeof(pending) - pendingBytes);
+			std::memcpy(pending + pendingBytes, p, take);
+			pendingBytes += take;
+			p += take;
+			bytes -= take;
+			if (pendingBytes < sizeof(pending))
+				return;
+			stripe(lanes, pending);
+			pendingBytes = 0;
+		}
+		for (; bytes >= 32; p += 32, bytes -= 32)
+			stripe(lanes, p);
+		if (bytes > 0)//p may be null for an empty payload
+			std::memcpy(pending, p, bytes);
+		pendingBytes = bytes;
+	}
+
+	std::uint64_t Checksum::value()const noexcept {
+		std::uint64_t hash;
+		if (total >= 32) {
+			hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+			for (std::uint64_t lane : lanes)
+				hash = mergeRound(hash, lane);
+		}
+		else {
+			hash = seed + prime5;
+		}
+		hash += total;
+
+		const std::byte* p = pending;
+		std::size_t left = pendingBytes;
+		for (; left >= 8; p += 8, left -= 8) {
+			hash ^= round(0, fetch<std::uint64_t>(p, 0));
+			hash = std::rotl(hash, 27) * prime1 + prime4;
+		}
+		if (left >= 4) {
+			hash ^= std::uint64_t(fetch<std::uint32_t>(p, 0)) * prime1;
+			hash = std::rotl(hash, 23) * prime2 + prime3;
+			p += 4;
+			left -= 4;
+		}
+		for (; left > 0; p++, left--) {
+			hash ^= std::uint64_t(*p) * prime5;
+			hash = std::rotl(hash, 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	std::uint64_t Checksum::of(const void* data, std::size_t bytes)noexcept {
+		Checksum sum;
+		sum.update(data, bytes);
+		return sum.value();
+	}
+	//#################################################
+
+	ByteWriter::ByteWriter(std::ostream& out, std::size_t chunk) :out(out) {
+		buffer.resize_for_overwrite(chunk);
+	}
+
+	void ByteWriter::write(const void* data, std::size_t bytes) {
+		if (bytes == 0)//empty Sequences hand in a null data()
+			return;
+		if (used + bytes <= buffer.size()) {
+			std::memcpy(buffer.data() + used, data, bytes);
+			used += bytes;
+			return;
+		}
+		flush();
+		if (bytes >= buffer.size()) {//wouldn't fit anyway, skip the copy
+			sum.update(data, bytes);
+			detail::writeExact(out, data, bytes);
+			return;
+		}
+		std::memcpy(buffer.data(), data, bytes);
+		used = bytes;
+	}
+
+	void ByteWriter::flush() {//checksummed here a chunk at a time, per field updates would cost more than the copying
+		if (used > 0) {
+			sum.update(buffer.data(), used);
+			detail::writeExact(out, buffer.data(), used);
+		}
+		used = 0;
+	}
+
+	ByteReader::ByteReader(std::istream& in, std::size_t chunk) :in(in) {
+		buffer.resize_for_overwrite(chunk);
+	}
+
+	void ByteReader::read(void* data, std::size_t bytes) {
+		if (bytes == 0)
+			return;
+		std::byte* dest = static_cast<std::byte*>(data);
+		while (bytes > 0) {
+			if (position == available) {
+				if (bytes >= buffer.size()) {//big block, straight from the stream into place
+					catchUp();
+					detail::readExact(in, dest, bytes);
+					sum.update(dest, bytes);
+					return;
+				}
+				refill();
+			}
+			const std::size_t take = std::min(bytes, available - position);
+			std::memcpy(dest, buffer.data() + position, take);
+			position += take;
+			dest += take;
+			bytes -= take;
+		}
+	}
+
+	void ByteReader::catchUp()noexcept {
+		sum.update(buffer.data() + summed, position - summed);
+		summed = position;
+	}
+
+	std::uint64_t ByteReader::checksum()noexcept {
+		catchUp();
+		return sum.value();
+	}
+
+	void ByteReader::refill() {
+		catchUp();
+		summed = 0;
+		in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		available = static_cast<std::size_t>(in.gcount());
+		position = 0;
+		if (available == 0)
+			throw FormatError("seq::io: unexpected end of stream");
+		in.clear(in.rdstate() & ~(std::ios::failbit | std::ios::eofbit));//a short last chunk is normal
+	}
+
+	void ByteReader::finish() {
+		if (position < available) {
+			in.seekg(-static_cast<std::streamoff>(available - position), std::ios::cur);
+			if (!in)
+				in.clear();//not seekable, whatever follows the record is gone
+		}
+		position = available = summed = 0;
+	}
+	//#################################################
+
+	namespace detail {
+		void writeExact(std::ostream& out, const void* data, std::size_t bytes) {
+			out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+			if (!out)
+				throw std::runtime_error("seq::io: write failed");
+		}
+
+		void readExact(std::istream& in, void* data, std::size_t bytes) {
+			in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+			if (static_cast<std::size_t>(in.gcount()) != bytes)
+				throw FormatError("seq::io: unexpected end of stream");
+		}
+
+		Header readHeader(std::istream& in) {
+			std::byte encoded[Header::bytes];
+			readExact(in, encoded, Header::bytes);
+			return Header::decode(encoded);
+		}
+
+#if defined(_WIN32)
+		RawFile::RawFile(const std::string& path, bool forWrite) {
+			HANDLE file = forWrite
+				? ::CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)
+				: ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				throwLastError("seq::io: open");
+			handle = file;
+		}
+
+		RawFile::~RawFile()noexcept {
+			::CloseHandle(handle);
+		}
+
+		void RawFile::writeGather(const ConstBuffer* parts, std::size_t count) {
+			for (std::size_t i = 0; i < count; i++) {
+				const char* p = static_cast<const char*>(parts[i].data);
+				std::size_t left = parts[i].bytes;
+				while (left > 0) {
+					const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(left, 1u << 30));
+					DWORD written = 0;
+					if (!::WriteFile(handle, p, chunk, &written, nullptr))
+						throwLastError("seq::io: write");
+					p += written;
+					left -= written;
+				}
+			}
+		}
+
+		void RawFile::readExact(void* data, std::size_t bytes) {
+			char* p = static_cast<char*>(data);
+			while (bytes > 0) {
+				const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(bytes, 1u << 30));
+				DWORD got = 0;
+				if (!::ReadFile(handle, p, chunk, &got, nullptr))
+					throwLastError("seq::io: read");
+				if (got == 0)
+					throw FormatError("seq::io: unexpected end of file");
+				p += got;
+				bytes -= got;
+			}
+		}
+
+		std::uint64_t RawFile::remaining()const {
+			if (::GetFileType(handle) != FILE_TYPE_DISK)
+				return unknown_size;
+			LARGE_INTEGER size, position, zero = {};
+			if (!::GetFileSizeEx(handle, &size) || !::SetFilePointerEx(handle, zero, &position, FILE_CURRENT))
+				throwLastError("seq::io: file size");
+			return size.QuadPart > position.QuadPart ? std::uint64_t(size.QuadPart - position.QuadPart) : 0;
+		}
+#else
+		RawFile::RawFile(const std::string& path, bool forWrite) {
+			fd = forWrite ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+				throwLastError("seq::io: open");
+		}
+
+		RawFile::~RawFile()noexcept {
+			::close(fd);
+		}
+
+		void RawFile::writeGather(const ConstBuffer* parts, std::size_t count) {//one syscall for header and payload, partial writes resumed
+			constexpr std::size_t max_parts = 16;
+			iovec vectors[max_parts];
+			std::size_t first = 0;
+			while (first < count) {
+				const std::size_t batch = std::min(count - first, max_parts);
+				for (std::size_t i = 0; i < batch; i++)
+					vectors[i] = { const_cast<void*>(parts[first + i].data), parts[first + i].bytes };
+
+				iovec* current = vectors;
+				std::size_t left = batch;
+				while (left > 0) {
+					const ssize_t written = ::writev(fd, current, static_cast<int>(left));
+					if (written < 0) {
+						if (errno == EINTR)
+							continue;
+						throwLastError("seq::io: writev");
+					}
+					std::size_t done = static_cast<std::size_t>(written);
+					while (left > 0 && done >= current->iov_len) {
+						done -= current->iov_len;
+						++current;
+						--left;
+					}
+					if (left > 0) {
+						current->iov_base = static_cast<char*>(current->iov_base) + done;
+						current->iov_len -= done;
+					}
+				}
+				first += batch;
+			}
+		}
+
+		void RawFile::readExact(void* data, std::size_t bytes) {
+			char* p = static_cast<char*>(data);
+			while (bytes > 0) {
+				const ssize_t got = ::read(fd, p, std::min<std::size_t>(bytes, SSIZE_MAX));
+				if (got < 0) {
+					if (errno == EINTR)
+						continue;
+					throwLastError("seq::io: read");
+				}
+				if (got == 0)
+					throw FormatError("seq::io: unexpected end of file");
+				p += got;
+				bytes -= static_cast<std::size_t>(got);
+			}
+		}
+
+		std::uint64_t RawFile::remaining()const {
+			struct stat info;
+			if (::fstat(fd, &info) != 0)
+				throwLastError("seq::io: fstat");
+			if (!S_ISREG(info.st_mode))
+				return unknown_size;
+			const off_t position = ::lseek(fd, 0, SEEK_CUR);
+			if (position < 0)
+				throwLastError("seq::io: lseek");
+			return info.st_size > position ? std::uint64_t(info.st_size - position) : 0;
+		}
+#endif
+	}
+}
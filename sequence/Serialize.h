@@ -0,0 +1,380 @@
+#pragma once
+
+#include "Sequence.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+//binary persistence for Sequence. one format, two payload encodings:
+//  raw     trivially copyable T, the payload is the element array byte for byte. written straight from data() (writev for files)
+//          and read straight into the uninitialized tail of the destination, no per element work at all
+//  chunked everything else, elements go through Codec<T> into a fixed size buffer that is flushed as it fills,
+//          so memory stays bounded by the chunk whatever the element count
+//layout: 40 byte header | payload | (chunked only) 8 byte checksum trailer. all integers in host byte order, the header
+//records which, and a reader on the other order refuses the file instead of misreading it
+namespace seq::io {
+	inline constexpr std::uint16_t format_version = 1;
+	inline constexpr std::size_t default_chunk = 64 * 1024;
+
+	struct FormatError : std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	struct Header {
+		static constexpr std::size_t bytes = 40;
+		enum Flags : std::uint16_t { raw = 0, chunked = 1 };
+
+		std::uint16_t version = format_version;
+		std::uint16_t flags = raw;
+		std::uint32_t elemSize = 0;
+		std::uint32_t elemAlign = 0;
+		std::uint64_t count = 0;
+		std::uint64_t checksum = 0;//raw payloads only, chunked ones carry it in the trailer since it is known only at the end
+
+		void encode(std::byte* out)const noexcept;
+		static Header decode(const std::byte* in);//throws FormatError on a bad magic, version or byte order
+		template <typename T>
+		void expect(Flags expectedFlags)const {
+			if (flags != expectedFlags)
+				throw FormatError(flags == raw ? "seq::io: raw payload, expected chunked" : "seq::io: chunked payload, expected raw");
+			if (elemSize != sizeof(T) || elemAlign != alignof(T))
+				throw FormatError("seq::io: element size or alignment doesn't match the stored type");
+		}
+	};
+
+	//xxh64, streaming. fast enough (several GB/s) that checking a payload costs about as much as reading it from cache
+	class Checksum {
+	public:
+		explicit Checksum(std::uint64_t seed = 0)noexcept;
+		void update(const void* data, std::size_t bytes)noexcept;
+		std::uint64_t value()const noexcept;
+		static std::uint64_t of(const void* data, std::size_t bytes)noexcept;
+	private:
+		std::uint64_t lanes[4];
+		std::byte pending[32];
+		std::size_t pendingBytes = 0;
+		std::uint64_t total = 0;
+		std::uint64_t seed;
+	};
+
+	//buffered, checksummed byte sinks and sources over iostreams. big blocks bypass the buffer
+	class ByteWriter {
+	public:
+		explicit ByteWriter(std::ostream& out, std::size_t chunk = default_chunk);
+		void write(const void* data, std::size_t bytes);
+		template <typename T>
+		void put(const T& value) requires std::is_trivially_copyable_v<T> { write(&value, sizeof(T)); }
+		void flush();
+		std::uint64_t checksum()const noexcept { return sum.value(); }//covers what was flushed, flush() first
+	private:
+		std::ostream& out;
+		Sequence<std::byte> buffer;
+		std::size_t used = 0;
+		Checksum sum;
+	};
+
+	class ByteReader {
+	public:
+		explicit ByteReader(std::istream& in, std::size_t chunk = default_chunk);
+		void read(void* data, std::size_t bytes);//throws FormatError when the stream ends early
+		template <typename T>
+		T get() requires std::is_trivially_copyable_v<T> {
+			T value;
+			read(&value, sizeof(T));
+			return value;
+		}
+		std::uint64_t checksum()noexcept;//over the bytes consumed so far
+		void finish();//hands read ahead bytes back to a seekable stream, so whatever follows the record can still be read
+	private:
+		void refill();
+		void catchUp()noexcept;//checksums the buffered bytes consumed since the last call
+
+		std::istream& in;
+		Sequence<std::byte> buffer;
+		std::size_t position = 0;
+		std::size_t available = 0;
+		std::size_t summed = 0;
+		Checksum sum;
+	};
+
+	namespace detail {
+		//counts come from the input. a corrupt one must end in FormatError, not in bad_alloc on a 2^62 element reservation,
+		//so a count is range checked first and then only believed trusted_bytes ahead of the data that backs it
+		inline constexpr std::size_t trusted_bytes = std::size_t(16) << 20;
+		template <typename T>
+		std::size_t checkedCount(std::uint64_t count, std::size_t maxCount) {
+			if (count > maxCount || count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+				throw FormatError("seq::io: element count out of range");
+			return static_cast<std::size_t>(count);
+		}
+		template <typename T>
+		constexpr std::size_t trustedCount()noexcept { return std::max<std::size_t>(trusted_bytes / sizeof(T), 1); }
+		//count trivially copyable elements in steps of trustedCount: grow(n) appends n and returns where they start,
+		//read(dest, bytes) fills them. one step, so one allocation, for anything up to trusted_bytes
+		template <typename T, typename Grow, typename Read>
+		void readInSteps(std::size_t count, Grow grow, Read read) {
+			while (count > 0) {
+				const std::size_t step = std::min(count, trustedCount<T>());
+				read(grow(step), step * sizeof(T));
+				count -= step;
+			}
+		}
+	}
+
+	//element encoding for the chunked path. specialize for your own types: encode(ByteWriter&, const T&) and T decode(ByteReader&)
+	template <typename T>
+	struct Codec;
+
+	template <typename T> requires std::is_trivially_copyable_v<T>
+	struct Codec<T> {
+		static void encode(ByteWriter& out, const T& value) { out.put(value); }
+		static T decode(ByteReader& in) { return in.get<T>(); }
+	};
+	template <typename Char, typename Traits, typename Alloc>
+	struct Codec<std::basic_string<Char, Traits, Alloc>> {
+		using String = std::basic_string<Char, Traits, Alloc>;
+		static void encode(ByteWriter& out, const String& value) {
+			out.put(std::uint64_t(value.size()));
+			out.write(value.data(), value.size() * sizeof(Char));
+		}
+		static String decode(ByteReader& in) {
+			String value;
+			const std::size_t count = detail::checkedCount<Char>(in.get<std::uint64_t>(), value.max_size());
+			detail::readInSteps<Char>(count,
+				[&value](std::size_t n) { value.resize(value.size() + n); return value.data() + value.size() - n; },
+				[&in](Char* dest, std::size_t bytes) { in.read(dest, bytes); });
+			return value;
+		}
+	};
+	template <typename U, typename Alloc, typename Growth>
+	struct Codec<Sequence<U, Alloc, Growth>> {
+		static void encode(ByteWriter& out, const Sequence<U, Alloc, Growth>& value) {
+			out.put(std::uint64_t(value.size()));
+			if constexpr (std::is_trivially_copyable_v<U>) {
+				out.write(value.data(), value.size() * sizeof(U));
+			}
+			else {
+				for (const U& elem : value)
+					Codec<U>::encode(out, elem);
+			}
+		}
+		static Sequence<U, Alloc, Growth> decode(ByteReader& in) {
+			Sequence<U, Alloc, Growth> value;
+			const std::size_t count = detail::checkedCount<U>(in.get<std::uint64_t>(), value.max_size());
+			if constexpr (std::is_trivially_copyable_v<U> && std::default_initializable<U>) {
+				detail::readInSteps<U>(count, [&value](std::size_t n) { return value.append_uninitialized(n); },
+					[&in](U* dest, std::size_t bytes) { in.read(dest, bytes); });
+			}
+			else {
+				value.reserve(std::min(count, detail::trustedCount<U>()));
+				for (std::size_t i = 0; i < count; i++)
+					value.push_back(Codec<U>::decode(in));
+			}
+			return value;
+		}
+	};
+
+	template <typename T>
+	concept raw_serializable = std::is_trivially_copyable_v<T> && std::default_initializable<T>;
+
+	namespace detail {
+		void writeExact(std::ostream& out, const void* data, std::size_t bytes);
+		void readExact(std::istream& in, void* data, std::size_t bytes);//throws FormatError when the stream ends early
+		Header readHeader(std::istream& in);
+
+		struct ConstBuffer {
+			const void* data;
+			std::size_t bytes;
+		};
+		//whole file helpers, writev/read on posix and WriteFile/ReadFile on windows, no stdio buffering in between
+		class RawFile {
+		public:
+			RawFile(const std::string& path, bool forWrite);
+			RawFile(const RawFile&) = delete;
+			RawFile& operator=(const RawFile&) = delete;
+			~RawFile()noexcept;
+			void writeGather(const ConstBuffer* parts, std::size_t count);
+			void readExact(void* data, std::size_t bytes);
+			static constexpr std::uint64_t unknown_size = std::numeric_limits<std::uint64_t>::max();
+			std::uint64_t remaining()const;//bytes between the read position and the end, unknown_size for pipes and devices
+		private:
+#if defined(_WIN32)
+			void* handle = nullptr;
+#else
+			int fd = -1;
+#endif
+		};
+	}
+
+	//STREAMS
+	//any sized range of T, chunked encoding through Codec<T>. the range is walked once, never copied
+	template <std::ranges::sized_range Range>
+	void writeStream(std::ostream& out, Range&& range, std::size_t chunk = default_chunk) {
+		using T = std::ranges::range_value_t<Range>;
+		Header header;
+		header.flags = Header::chunked;
+		header.elemSize = sizeof(T);
+		header.elemAlign = alignof(T);
+		header.count = std::ranges::size(range);
+		std::byte encoded[Header::bytes];
+		header.encode(encoded);
+		detail::writeExact(out, encoded, Header::bytes);
+
+		ByteWriter writer(out, chunk);
+		for (const auto& elem : range)
+			Codec<T>::encode(writer, elem);
+		writer.flush();
+		const std::uint64_t trailer = writer.checksum();
+		detail::writeExact(out, &trailer, sizeof(trailer));
+	}
+	namespace detail {
+		template <typename T, typename Visit>
+		void readChunked(std::istream& in, const Header& header, Visit& visit, std::size_t chunk) {//everything after the header
+			ByteReader reader(in, chunk);
+			for (std::uint64_t i = 0; i < header.count; i++)
+				visit(Codec<T>::decode(reader));
+			const std::uint64_t expected = reader.checksum();
+			const std::uint64_t trailer = reader.get<std::uint64_t>();
+			reader.finish();
+			if (trailer != expected)
+				throw FormatError("seq::io: checksum mismatch");
+		}
+	}
+	//chunked counterpart, visit(T&&) per element as it is decoded. memory stays at one chunk plus one element. returns the count
+	template <typename T, typename Visit>
+	std::size_t readStream(std::istream& in, Visit visit, std::size_t chunk = default_chunk) {
+		const Header header = detail::readHeader(in);
+		header.expect<T>(Header::chunked);
+		detail::readChunked<T>(in, header, visit, chunk);
+		return static_cast<std::size_t>(header.count);
+	}
+
+	//whole Sequence or any window of one, picks the encoding from T. both write the same bytes, read() takes either
+	template <typename T>
+	void write(std::ostream& out, SequenceView<T> view) {
+		using V = std::remove_cv_t<T>;
+		if constexpr (raw_serializable<V>) {
+			Header header;
+			header.elemSize = sizeof(V);
+			header.elemAlign = alignof(V);
+			header.count = view.size();
+			header.checksum = Checksum::of(view.data(), view.size_bytes());
+			std::byte encoded[Header::bytes];
+			header.encode(encoded);
+			detail::writeExact(out, encoded, Header::bytes);
+			detail::writeExact(out, view.data(), view.size_bytes());
+		}
+		else {
+			writeStream(out, view);
+		}
+	}
+	template <typename T, typename Allocator, typename Growth>
+	void write(std::ostream& out, const Sequence<T, Allocator, Growth>& sequence) {
+		write(out, sequence.view());
+	}
+	//appends to into, which keeps whatever it held. on a throw into is left as it was
+	template <typename T, typename Allocator, typename Growth>
+	void read(std::istream& in, Sequence<T, Allocator, Growth>& into) {
+		if constexpr (raw_serializable<T>) {
+			const Header header = detail::readHeader(in);
+			header.expect<T>(Header::raw);
+			const std::size_t count = detail::checkedCount<T>(header.count, into.max_size() - into.size());
+			const std::size_t oldSize = into.size();
+			try {
+				detail::readInSteps<T>(count, [&into](std::size_t n) { return into.append_uninitialized(n); },
+					[&in](T* dest, std::size_t bytes) { detail::readExact(in, dest, bytes); });
+				if (Checksum::of(into.data() + oldSize, count * sizeof(T)) != header.checksum)
+					throw FormatError("seq::io: checksum mismatch");
+			}
+			catch (...) {
+				into.resize_shrink(oldSize);
+				throw;
+			}
+		}
+		else {
+			const Header header = detail::readHeader(in);
+			header.expect<T>(Header::chunked);
+			const std::size_t count = detail::checkedCount<T>(header.count, into.max_size() - into.size());
+			const std::size_t oldSize = into.size();
+			try {
+				into.reserve(oldSize + std::min(count, detail::trustedCount<T>()));
+				auto append = [&into](T&& value) { into.push_back(std::move(value)); };
+				detail::readChunked<T>(in, header, append, default_chunk);
+			}
+			catch (...) {
+				into.resize_shrink(oldSize);
+				throw;
+			}
+		}
+	}
+	//#################################################
+
+	//FILES, raw Sequences skip iostreams entirely: one writev of header + data(), one read into the new tail
+	template <typename T>
+	void save(const std::string& path, SequenceView<T> view) {
+		using V = std::remove_cv_t<T>;
+		if constexpr (raw_serializable<V>) {
+			Header header;
+			header.elemSize = sizeof(V);
+			header.elemAlign = alignof(V);
+			header.count = view.size();
+			header.checksum = Checksum::of(view.data(), view.size_bytes());
+			std::byte encoded[Header::bytes];
+			header.encode(encoded);
+
+			const detail::ConstBuffer parts[] = { { encoded, Header::bytes }, { view.data(), view.size_bytes() } };
+			detail::RawFile(path, true).writeGather(parts, 2);
+		}
+		else {
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			if (!out)
+				throw std::runtime_error("seq::io: can't open " + path);
+			writeStream(out, view);
+		}
+	}
+	template <typename T, typename Allocator, typename Growth>
+	void save(const std::string& path, const Sequence<T, Allocator, Growth>& sequence) {
+		save(path, sequence.view());
+	}
+	template <typename T, typename Allocator, typename Growth>
+	void load(const std::string& path, Sequence<T, Allocator, Growth>& into) {
+		if constexpr (raw_serializable<T>) {
+			detail::RawFile file(path, false);
+			std::byte encoded[Header::bytes];
+			file.readExact(encoded, Header::bytes);
+			const Header header = Header::decode(encoded);
+			header.expect<T>(Header::raw);
+
+			//a regular file says how much data there is, so the count is checked against it and read in one go
+			const std::uint64_t remaining = file.remaining();
+			if (remaining != detail::RawFile::unknown_size && header.count > remaining / sizeof(T))
+				throw FormatError("seq::io: file shorter than its element count");
+			const std::size_t count = detail::checkedCount<T>(header.count, into.max_size() - into.size());
+			const std::size_t oldSize = into.size();
+			try {
+				if (remaining != detail::RawFile::unknown_size)
+					file.readExact(into.append_uninitialized(count), count * sizeof(T));
+				else
+					detail::readInSteps<T>(count, [&into](std::size_t n) { return into.append_uninitialized(n); },
+						[&file](T* dest, std::size_t bytes) { file.readExact(dest, bytes); });
+				if (Checksum::of(into.data() + oldSize, count * sizeof(T)) != header.checksum)
+					throw FormatError("seq::io: checksum mismatch");
+			}
+			catch (...) {
+				into.resize_shrink(oldSize);
+				throw;
+			}
+		}
+		else {
+			std::ifstream in(path, std::ios::binary);
+			if (!in)
+				throw std::runtime_error("seq::io: can't open " + path);
+			read(in, into);
+		}
+	}
+}
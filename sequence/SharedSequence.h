@@ -0,0 +1,330 @@
+#pragma once
+
+#include "Sequence.h"
+#include <atomic>
+
+namespace seq {
+	//forward declares
+	template <typename T, typename Allocator, typename Growth>
+	class FrozenSequence;
+
+	namespace detail {
+		//one reference counted Sequence on the heap, the thing CowSequence and FrozenSequence point to. allocated through the
+		//Sequence's own allocator rebound, so the whole handle is a single pointer and an empty one holds no memory at all
+		template <typename T, typename Allocator, typename Growth>
+		class SharedBlock {
+		public:
+			using sequence_type = Sequence<T, Allocator, Growth>;
+
+			template <typename... Args>
+			static SharedBlock* make(const Allocator& allocator, Args&&... args) {
+				block_alloc alloc(allocator);
+				SharedBlock* block = std::to_address(block_traits::allocate(alloc, 1));
+				try {
+					std::construct_at(block, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					block_traits::deallocate(alloc, block, 1);
+					throw;
+				}
+				return block;
+			}
+			static void acquire(SharedBlock* block)noexcept {
+				if (block)
+					block->refs.fetch_add(1, std::memory_order_relaxed);//a new owner can only come from an existing one, nothing to order
+			}
+			static void release(SharedBlock* block)noexcept {
+				if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {//the last owner sees every other owner's writes
+					block_alloc alloc(block->items.get_allocator());
+					std::destroy_at(block);
+					block_traits::deallocate(alloc, block, 1);
+				}
+			}
+
+			template <typename... Args>
+			explicit SharedBlock(Args&&... args) :items(std::forward<Args>(args)...) {}
+
+			bool isUnique()const noexcept { return refs.load(std::memory_order_acquire) == 1; }
+			std::size_t use_count()const noexcept { return refs.load(std::memory_order_relaxed); }
+
+			std::atomic<std::size_t> refs = 1;
+			sequence_type items;
+		private:
+			using block_alloc  = typename std::allocator_traits<Allocator>::template rebind_alloc<SharedBlock>;
+			using block_traits = std::allocator_traits<block_alloc>;
+		};
+	}
+
+	//copy on write Sequence: copies share one buffer behind an atomic count and cost an increment, the first mutation through
+	//a shared handle makes it a private deep copy first (detach). handles to one buffer can live on different threads like
+	//shared_ptrs, a single handle isn't synchronized. non const access (operator[], begin(), data()...) counts as mutation since
+	//the reference could be written through, read through a const handle or read() to keep sharing
+	template <typename T, typename Allocator = std::allocator<T>, typename Growth = GrowGeometric>
+	class CowSequence {
+	private:
+		using block_type = detail::SharedBlock<T, Allocator, Growth>;
+	public:
+		//type names
+		using type            = CowSequence<T, Allocator, Growth>;
+		using sequence_type   = Sequence<T, Allocator, Growth>;
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = typename sequence_type::iterator;
+		using const_iterator  = typename sequence_type::const_iterator;
+		//#################################################
+
+	private:
+		//the important shit
+		sequence_type& mutate() {//private copy from here on, made only if someone else holds the buffer too
+			if (!block) {
+				block = block_type::make(alloc, alloc);
+			}
+			else if (!block->isUnique()) {
+				block_type* copy = block_type::make(alloc, std::as_const(block->items), alloc);
+				block_type::release(std::exchange(block, copy));
+			}
+			return block->items;
+		}
+		static const sequence_type& none() {
+			static const sequence_type empty;
+			return empty;
+		}
+		friend class FrozenSequence<T, Allocator, Growth>;
+		explicit CowSequence(block_type* shared, const allocator_type& allocator)noexcept :alloc(allocator), block(shared) {
+			block_type::acquire(block);
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		CowSequence()noexcept(std::is_nothrow_default_constructible_v<allocator_type>) requires std::default_initializable<allocator_type> = default;
+		explicit CowSequence(const allocator_type& allocator)noexcept :alloc(allocator) {}
+		CowSequence(sequence_type&& items) :alloc(items.get_allocator()), block(block_type::make(alloc, std::move(items))) {}//the buffer moves in, nothing is copied
+		explicit CowSequence(const sequence_type& items) :alloc(items.get_allocator()), block(block_type::make(alloc, items)) {}
+		CowSequence(std::initializer_list<value_type> init, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type>
+			:alloc(allocator), block(block_type::make(alloc, init, allocator)) {}
+		CowSequence(const CowSequence& rhs)noexcept :alloc(rhs.alloc), block(rhs.block) {
+			block_type::acquire(block);
+		}
+		CowSequence(CowSequence&& rhs)noexcept :alloc(rhs.alloc), block(std::exchange(rhs.block, nullptr)) {}
+		CowSequence& operator=(const CowSequence& rhs)noexcept {
+			block_type::acquire(rhs.block);//first, so self assignment never drops the count to zero
+			block_type::release(std::exchange(block, rhs.block));
+			alloc = rhs.alloc;
+			return *this;
+		}
+		CowSequence& operator=(CowSequence&& rhs)noexcept {
+			if (this != &rhs) {
+				block_type::release(std::exchange(block, std::exchange(rhs.block, nullptr)));
+				alloc = rhs.alloc;
+			}
+			return *this;
+		}
+		~CowSequence()noexcept {
+			block_type::release(block);
+		}
+		//#################################################
+
+		//ACCESS, const: reads the shared buffer as is
+		const sequence_type& read()const noexcept           { return block ? block->items : none(); }
+		const_reference front()const                        { return read().front(); }
+		const_reference back()const                         { return read().back(); }
+		const_reference operator[](size_type index)const    { return read()[index]; }
+		const_reference at(size_type pos)const              { return read().at(pos); }
+		const_pointer   data()const noexcept                { return read().data(); }
+		const_iterator  begin()const noexcept               { return read().begin(); }
+		const_iterator  end()const noexcept                 { return read().end(); }
+		const_iterator  cbegin()const noexcept              { return read().cbegin(); }
+		const_iterator  cend()const noexcept                { return read().cend(); }
+		SequenceView<const value_type> view()const noexcept { return read().view(); }
+
+		//non const: detaches first, the result is this handle's own
+		sequence_type& edit()                      { return mutate(); }
+		reference      front()                     { return mutate().front(); }
+		reference      back()                      { return mutate().back(); }
+		reference      operator[](size_type index) { return mutate()[index]; }
+		reference      at(size_type pos)           { return mutate().at(pos); }
+		pointer        data()                      { return mutate().data(); }
+		iterator       begin()                     { return mutate().begin(); }
+		iterator       end()                       { return mutate().end(); }
+		//#################################################
+
+		//MODIFICATION
+		template <typename U>
+		void push_back(U&& value) requires std::convertible_to<U, value_type> && std::constructible_from<value_type, U&&> {
+			mutate().push_back(std::forward<U>(value));
+		}
+		template <typename... Args>
+		void emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			mutate().emplace_back(std::forward<Args>(args)...);
+		}
+		template <std::ranges::input_range Range>
+		void append_range(Range&& range) requires std::constructible_from<value_type, std::ranges::range_reference_t<Range>> && strong_movable<value_type> {
+			mutate().append_range(std::forward<Range>(range));
+		}
+		void pop_back() {
+			mutate().pop_back();
+		}
+		//positions are taken as offsets before detaching, so an iterator into the buffer this handle shared is still fine
+		iterator erase(const_iterator pos) requires strong_movable<value_type> {
+			const difference_type at = pos - cbegin();
+			sequence_type& items = mutate();
+			return items.erase(items.begin() + at);
+		}
+		iterator erase(const_iterator first, const_iterator last) requires strong_movable<value_type> {
+			const difference_type from = first - cbegin();
+			const difference_type till = last - cbegin();
+			sequence_type& items = mutate();
+			return items.erase(items.begin() + from, items.begin() + till);
+		}
+		template <typename UnaryPred>
+		size_type erase_if(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred&, const_reference> {
+			return mutate().erase_if(std::move(predicate));
+		}
+		void reserve(size_type newCap) requires strong_movable<value_type> {
+			mutate().reserve(newCap);
+		}
+		void clear()noexcept {//a shared buffer is just let go, no point copying what is about to be destroyed
+			if (block && !block->isUnique())
+				block_type::release(std::exchange(block, nullptr));
+			else if (block)
+				block->items.clear();
+		}
+		void swap(CowSequence& rhs)noexcept {
+			using std::swap;
+			swap(alloc, rhs.alloc);
+			swap(block, rhs.block);
+		}
+		//an immutable handle to the current contents, shares the buffer. this handle detaches on its next mutation
+		FrozenSequence<T, Allocator, Growth> freeze()const noexcept;
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept   { return size() == 0; }
+		size_type size()const noexcept      { return block ? block->items.size() : 0; }
+		size_type capacity()const noexcept  { return block ? block->items.capacity() : 0; }
+		bool      isShared()const noexcept  { return block && !block->isUnique(); }
+		size_type use_count()const noexcept { return block ? block->use_count() : 0; }//a hint, other threads may change it any time
+		allocator_type get_allocator()const noexcept { return alloc; }
+		//#################################################
+	private:
+		//members
+		SEQ_NO_UNIQUE_ADDRESS allocator_type alloc;
+		block_type* block = nullptr;
+	};
+
+	//immutable shared Sequence: the contents are fixed when it's made, so any number of threads read any number of copies with
+	//no synchronization at all, copies are an atomic increment. made from a Sequence moved in, or by CowSequence::freeze()
+	template <typename T, typename Allocator = std::allocator<T>, typename Growth = GrowGeometric>
+	class FrozenSequence {
+	private:
+		using block_type = detail::SharedBlock<T, Allocator, Growth>;
+
+		static const typename block_type::sequence_type& none() {
+			static const typename block_type::sequence_type empty;
+			return empty;
+		}
+		friend class CowSequence<T, Allocator, Growth>;
+		explicit FrozenSequence(block_type* shared)noexcept :block(shared) {
+			block_type::acquire(block);
+		}
+	public:
+		//type names
+		using type            = FrozenSequence<T, Allocator, Growth>;
+		using sequence_type   = Sequence<T, Allocator, Growth>;
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using const_pointer   = const T*;
+		using reference       = const T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = typename sequence_type::const_iterator;
+		using const_iterator  = typename sequence_type::const_iterator;
+		//#################################################
+
+		//CONSTRUCTORS
+		FrozenSequence()noexcept = default;
+		FrozenSequence(sequence_type&& items) :block(block_type::make(items.get_allocator(), std::move(items))) {}
+		explicit FrozenSequence(const sequence_type& items) :block(block_type::make(items.get_allocator(), items)) {}
+		FrozenSequence(std::initializer_list<value_type> init, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type>
+			:block(block_type::make(allocator, init, allocator)) {}
+		FrozenSequence(const FrozenSequence& rhs)noexcept :block(rhs.block) {
+			block_type::acquire(block);
+		}
+		FrozenSequence(FrozenSequence&& rhs)noexcept :block(std::exchange(rhs.block, nullptr)) {}
+		FrozenSequence& operator=(const FrozenSequence& rhs)noexcept {
+			block_type::acquire(rhs.block);
+			block_type::release(std::exchange(block, rhs.block));
+			return *this;
+		}
+		FrozenSequence& operator=(FrozenSequence&& rhs)noexcept {
+			if (this != &rhs)
+				block_type::release(std::exchange(block, std::exchange(rhs.block, nullptr)));
+			return *this;
+		}
+		~FrozenSequence()noexcept {
+			block_type::release(block);
+		}
+		//#################################################
+
+		//ACCESS
+		const sequence_type& read()const noexcept           { return block ? block->items : none(); }
+		const_reference front()const                        { return read().front(); }
+		const_reference back()const                         { return read().back(); }
+		const_reference operator[](size_type index)const    { return read()[index]; }
+		const_reference at(size_type pos)const              { return read().at(pos); }
+		const_pointer   data()const noexcept                { return read().data(); }
+		const_iterator  begin()const noexcept               { return read().begin(); }
+		const_iterator  end()const noexcept                 { return read().end(); }
+		const_iterator  cbegin()const noexcept              { return read().cbegin(); }
+		const_iterator  cend()const noexcept                { return read().cend(); }
+		SequenceView<const value_type> view()const noexcept { return read().view(); }
+		//a writable handle sharing the buffer, it copies on its first mutation
+		CowSequence<T, Allocator, Growth> thaw()const {
+			return CowSequence<T, Allocator, Growth>(block, block ? block->items.get_allocator() : allocator_type());
+		}
+		void swap(FrozenSequence& rhs)noexcept {
+			std::swap(block, rhs.block);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept   { return size() == 0; }
+		size_type size()const noexcept      { return block ? block->items.size() : 0; }
+		size_type use_count()const noexcept { return block ? block->use_count() : 0; }
+		//#################################################
+	private:
+		//members
+		block_type* block = nullptr;
+	};
+
+	template <typename T, typename Allocator, typename Growth>
+	FrozenSequence<T, Allocator, Growth> CowSequence<T, Allocator, Growth>::freeze()const noexcept {
+		return FrozenSequence<T, Allocator, Growth>(block);
+	}
+
+	template <typename T, typename Allocator, typename Growth>
+	bool operator==(const CowSequence<T, Allocator, Growth>& lhs, const CowSequence<T, Allocator, Growth>& rhs) {
+		return lhs.read() == rhs.read();
+	}
+	template <typename T, typename Allocator, typename Growth>
+	bool operator==(const FrozenSequence<T, Allocator, Growth>& lhs, const FrozenSequence<T, Allocator, Growth>& rhs) {
+		return lhs.read() == rhs.read();
+	}
+	template <typename T, typename Allocator, typename Growth>
+	void swap(CowSequence<T, Allocator, Growth>& lhs, CowSequence<T, Allocator, Growth>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+	template <typename T, typename Allocator, typename Growth>
+	void swap(FrozenSequence<T, Allocator, Growth>& lhs, FrozenSequence<T, Allocator, Growth>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,738 @@
+#include "Simd.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SEQ_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+//one binary, every level: the kernels are written once against a traits struct per (instruction set, lane type), then stamped out
+//in an entry function carrying that instruction set's target attribute. msvc needs no attribute, any intrinsic compiles anywhere
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SEQ_TARGET(isa)
+#define SEQ_INLINE __forceinline
+#else
+#define SEQ_TARGET(isa) __attribute__((target(isa)))
+#define SEQ_INLINE [[gnu::always_inline]] inline
+#pragma GCC diagnostic ignored "-Wpsabi"//vectors only ever cross always_inline calls, there is no ABI to change
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"//gcc 12's avx512 headers trip it on their own _mm512_undefined passthroughs
+#endif
+
+namespace seq::simd {
+	namespace {
+		Level detect()noexcept {
+#if !defined(SEQ_SIMD_X86)
+			return Level::scalar;
+#elif defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+			__cpuid(info, 1);
+			if (!(info[3] & (1 << 26)))
+				return Level::scalar;
+			const bool osSaves = (info[2] & (1 << 27)) && (info[2] & (1 << 28));//osxsave and avx
+			const unsigned long long xcr0 = osSaves ? _xgetbv(0) : 0;
+			if ((xcr0 & 0x6) != 0x6 || maxLeaf < 7)
+				return Level::sse2;
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)//avx512f and the os saving the zmm state
+				return Level::avx512;
+			return (info[1] & (1 << 5)) ? Level::avx2 : Level::sse2;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f"))
+				return Level::avx512;
+			if (__builtin_cpu_supports("avx2"))
+				return Level::avx2;
+			return __builtin_cpu_supports("sse2") ? Level::sse2 : Level::scalar;
+#endif
+		}
+
+		std::atomic<Level>& active()noexcept {
+			static std::atomic<Level> level{ detectedLevel() };
+			return level;
+		}
+	}
+
+	Level detectedLevel()noexcept {
+		static const Level level = detect();
+		return level;
+	}
+	Level activeLevel()noexcept {
+		return active().load(std::memory_order_relaxed);
+	}
+	Level setLevel(Level level)noexcept {
+		const Level effective = std::min(level, detectedLevel());
+		active().store(effective, std::memory_order_relaxed);
+		return effective;
+	}
+	const char* levelName(Level level)noexcept {
+		switch (level) {
+		case Level::sse2:   return "sse2";
+		case Level::avx2:   return "avx2";
+		case Level::avx512: return "avx512";
+		default:            return "scalar";
+		}
+	}
+
+	namespace {
+		//every traits struct has the same shape: vec, lanes, load/set1/store, eq -> one bit per lane, min/max, and a widened
+		//accumulator for sum. Scalar is the one lane version, it runs the tails and the whole range when nothing better exists
+		template <typename S>
+		SEQ_INLINE S wrapAdd(S a, S b) {//integer sums wrap like the vector adds do, without the signed overflow
+			if constexpr (std::is_integral_v<S>)
+				return S(std::uint64_t(a) + std::uint64_t(b));
+			else
+				return a + b;
+		}
+
+		template <typename L>
+		struct Scalar {
+			using lane = L;
+			using vec = L;
+			using acc = sum_t<L>;
+			static constexpr unsigned lanes = 1;
+			static constexpr unsigned accLanes = 1;
+
+			SEQ_INLINE static vec load(const std::byte* p) { L value; std::memcpy(&value, p, sizeof(L)); return value; }
+			SEQ_INLINE static vec set1(L value) { return value; }
+			SEQ_INLINE static void store(L* out, vec v) { *out = v; }
+			SEQ_INLINE static unsigned eq(vec a, vec b) { return a == b; }
+			SEQ_INLINE static vec min(vec a, vec b) { return b < a ? b : a; }
+			SEQ_INLINE static vec max(vec a, vec b) { return a < b ? b : a; }
+			SEQ_INLINE static acc zero() { return 0; }
+			SEQ_INLINE static acc add(acc total, vec v) { return wrapAdd(total, acc(v)); }
+			SEQ_INLINE static void storeAcc(sum_t<L>* out, acc total) { *out = total; }
+		};
+
+#if defined(SEQ_SIMD_X86)
+		//SSE2, the x86-64 baseline. no 32bit min/max, no 64bit compares, no widening converts: all emulated from what's there
+		template <typename L> struct Sse2;
+
+		struct Sse2Int {
+			using vec = __m128i;
+			SEQ_TARGET("sse2") static vec load(const std::byte* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+			SEQ_TARGET("sse2") static vec select(vec mask, vec a, vec b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+			SEQ_TARGET("sse2") static vec gt64(vec a, vec b) {//high halves decide, equal high halves take the borrow of the low ones
+				vec r = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+				r = _mm_or_si128(r, _mm_cmpgt_epi32(a, b));
+				return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 1, 1));
+			}
+			SEQ_TARGET("sse2") static unsigned eq32(vec a, vec b) { return unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+			SEQ_TARGET("sse2") static unsigned eq64(vec a, vec b) {
+				const vec halves = _mm_cmpeq_epi32(a, b);
+				return unsigned(_mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))))));
+			}
+		};
+		template <> struct Sse2<std::int32_t> :Sse2Int {
+			using lane = std::int32_t;
+			using acc = __m128i;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_epi32(value); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return eq32(a, b); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_si128(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) {
+				const vec sign = _mm_cmpgt_epi32(_mm_setzero_si128(), v);
+				total = _mm_add_epi64(total, _mm_unpacklo_epi32(v, sign));
+				return _mm_add_epi64(total, _mm_unpackhi_epi32(v, sign));
+			}
+			SEQ_TARGET("sse2") static void storeAcc(std::int64_t* out, acc total) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), total); }
+		};
+		template <> struct Sse2<std::uint32_t> :Sse2Int {
+			using lane = std::uint32_t;
+			using acc = __m128i;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec flip(vec v) { return _mm_xor_si128(v, _mm_set1_epi32(INT32_MIN)); }
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_epi32(std::int32_t(value)); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return eq32(a, b); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return select(_mm_cmpgt_epi32(flip(a), flip(b)), b, a); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return select(_mm_cmpgt_epi32(flip(a), flip(b)), a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_si128(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) {
+				total = _mm_add_epi64(total, _mm_unpacklo_epi32(v, _mm_setzero_si128()));
+				return _mm_add_epi64(total, _mm_unpackhi_epi32(v, _mm_setzero_si128()));
+			}
+			SEQ_TARGET("sse2") static void storeAcc(std::uint64_t* out, acc total) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), total); }
+		};
+		template <> struct Sse2<std::int64_t> :Sse2Int {
+			using lane = std::int64_t;
+			using acc = __m128i;
+			static constexpr unsigned lanes = 2;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_epi64x(value); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return eq64(a, b); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return select(gt64(a, b), b, a); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return select(gt64(a, b), a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_si128(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) { return _mm_add_epi64(total, v); }
+			SEQ_TARGET("sse2") static void storeAcc(std::int64_t* out, acc total) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), total); }
+		};
+		template <> struct Sse2<std::uint64_t> :Sse2Int {
+			using lane = std::uint64_t;
+			using acc = __m128i;
+			static constexpr unsigned lanes = 2;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec flip(vec v) { return _mm_xor_si128(v, _mm_set1_epi64x(INT64_MIN)); }
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_epi64x(std::int64_t(value)); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return eq64(a, b); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return select(gt64(flip(a), flip(b)), b, a); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return select(gt64(flip(a), flip(b)), a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_si128(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) { return _mm_add_epi64(total, v); }
+			SEQ_TARGET("sse2") static void storeAcc(std::uint64_t* out, acc total) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), total); }
+		};
+		template <> struct Sse2<float> {
+			using lane = float;
+			using vec = __m128;
+			using acc = __m128d;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec load(const std::byte* p) { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_ps(value); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_ps(out, v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return unsigned(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_pd(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) {
+				total = _mm_add_pd(total, _mm_cvtps_pd(v));
+				return _mm_add_pd(total, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+			}
+			SEQ_TARGET("sse2") static void storeAcc(double* out, acc total) { _mm_storeu_pd(out, total); }
+		};
+		template <> struct Sse2<double> {
+			using lane = double;
+			using vec = __m128d;
+			using acc = __m128d;
+			static constexpr unsigned lanes = 2;
+			static constexpr unsigned accLanes = 2;
+			SEQ_TARGET("sse2") static vec load(const std::byte* p) { return _mm_loadu_pd(reinterpret_cast<const double*>(p)); }
+			SEQ_TARGET("sse2") static vec set1(lane value) { return _mm_set1_pd(value); }
+			SEQ_TARGET("sse2") static void store(lane* out, vec v) { _mm_storeu_pd(out, v); }
+			SEQ_TARGET("sse2") static unsigned eq(vec a, vec b) { return unsigned(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+			SEQ_TARGET("sse2") static vec min(vec a, vec b) { return _mm_min_pd(a, b); }
+			SEQ_TARGET("sse2") static vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+			SEQ_TARGET("sse2") static acc zero() { return _mm_setzero_pd(); }
+			SEQ_TARGET("sse2") static acc add(acc total, vec v) { return _mm_add_pd(total, v); }
+			SEQ_TARGET("sse2") static void storeAcc(double* out, acc total) { _mm_storeu_pd(out, total); }
+		};
+
+		//AVX2, 256bit. still no 64bit min/max, a compare and a blend stand in
+		template <typename L> struct Avx2;
+
+		struct Avx2Int {
+			using vec = __m256i;
+			SEQ_TARGET("avx2") static vec load(const std::byte* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+			SEQ_TARGET("avx2") static unsigned eq32(vec a, vec b) { return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+			SEQ_TARGET("avx2") static unsigned eq64(vec a, vec b) { return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))); }
+		};
+		template <> struct Avx2<std::int32_t> :Avx2Int {
+			using lane = std::int32_t;
+			using acc = __m256i;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_epi32(value); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return eq32(a, b); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_min_epi32(a, b); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_max_epi32(a, b); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_si256(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) {
+				total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+				return _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+			}
+			SEQ_TARGET("avx2") static void storeAcc(std::int64_t* out, acc total) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), total); }
+		};
+		template <> struct Avx2<std::uint32_t> :Avx2Int {
+			using lane = std::uint32_t;
+			using acc = __m256i;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_epi32(std::int32_t(value)); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return eq32(a, b); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_min_epu32(a, b); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_max_epu32(a, b); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_si256(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) {
+				total = _mm256_add_epi64(total, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+				return _mm256_add_epi64(total, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+			}
+			SEQ_TARGET("avx2") static void storeAcc(std::uint64_t* out, acc total) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), total); }
+		};
+		template <> struct Avx2<std::int64_t> :Avx2Int {
+			using lane = std::int64_t;
+			using acc = __m256i;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_epi64x(value); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return eq64(a, b); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_si256(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) { return _mm256_add_epi64(total, v); }
+			SEQ_TARGET("avx2") static void storeAcc(std::int64_t* out, acc total) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), total); }
+		};
+		template <> struct Avx2<std::uint64_t> :Avx2Int {
+			using lane = std::uint64_t;
+			using acc = __m256i;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec gt(vec a, vec b) {
+				const vec flip = _mm256_set1_epi64x(INT64_MIN);
+				return _mm256_cmpgt_epi64(_mm256_xor_si256(a, flip), _mm256_xor_si256(b, flip));
+			}
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_epi64x(std::int64_t(value)); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return eq64(a, b); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_blendv_epi8(a, b, gt(a, b)); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_blendv_epi8(b, a, gt(a, b)); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_si256(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) { return _mm256_add_epi64(total, v); }
+			SEQ_TARGET("avx2") static void storeAcc(std::uint64_t* out, acc total) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), total); }
+		};
+		template <> struct Avx2<float> {
+			using lane = float;
+			using vec = __m256;
+			using acc = __m256d;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec load(const std::byte* p) { return _mm256_loadu_ps(reinterpret_cast<const float*>(p)); }
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_ps(value); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_ps(out, v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_pd(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) {
+				total = _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+				return _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+			}
+			SEQ_TARGET("avx2") static void storeAcc(double* out, acc total) { _mm256_storeu_pd(out, total); }
+		};
+		template <> struct Avx2<double> {
+			using lane = double;
+			using vec = __m256d;
+			using acc = __m256d;
+			static constexpr unsigned lanes = 4;
+			static constexpr unsigned accLanes = 4;
+			SEQ_TARGET("avx2") static vec load(const std::byte* p) { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+			SEQ_TARGET("avx2") static vec set1(lane value) { return _mm256_set1_pd(value); }
+			SEQ_TARGET("avx2") static void store(lane* out, vec v) { _mm256_storeu_pd(out, v); }
+			SEQ_TARGET("avx2") static unsigned eq(vec a, vec b) { return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+			SEQ_TARGET("avx2") static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+			SEQ_TARGET("avx2") static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+			SEQ_TARGET("avx2") static acc zero() { return _mm256_setzero_pd(); }
+			SEQ_TARGET("avx2") static acc add(acc total, vec v) { return _mm256_add_pd(total, v); }
+			SEQ_TARGET("avx2") static void storeAcc(double* out, acc total) { _mm256_storeu_pd(out, total); }
+		};
+
+		//AVX-512F, 512bit. compares land in mask registers, which already are the one bit per lane the kernels want
+		template <typename L> struct Avx512;
+
+		struct Avx512Int {
+			using vec = __m512i;
+			using acc = __m512i;
+			SEQ_TARGET("avx512f") static vec load(const std::byte* p) { return _mm512_loadu_si512(p); }
+			SEQ_TARGET("avx512f") static acc zero() { return _mm512_setzero_si512(); }
+			SEQ_TARGET("avx512f") static void store(void* out, vec v) { _mm512_storeu_si512(out, v); }
+			SEQ_TARGET("avx512f") static void storeAcc(void* out, acc total) { _mm512_storeu_si512(out, total); }
+		};
+		template <> struct Avx512<std::int32_t> :Avx512Int {
+			using lane = std::int32_t;
+			static constexpr unsigned lanes = 16;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_epi32(value); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmpeq_epi32_mask(a, b); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_epi32(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_epi32(a, b); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) {
+				total = _mm512_add_epi64(total, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+				return _mm512_add_epi64(total, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+			}
+		};
+		template <> struct Avx512<std::uint32_t> :Avx512Int {
+			using lane = std::uint32_t;
+			static constexpr unsigned lanes = 16;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_epi32(std::int32_t(value)); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmpeq_epi32_mask(a, b); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_epu32(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_epu32(a, b); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) {
+				total = _mm512_add_epi64(total, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(v)));
+				return _mm512_add_epi64(total, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+			}
+		};
+		template <> struct Avx512<std::int64_t> :Avx512Int {
+			using lane = std::int64_t;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_epi64(value); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmpeq_epi64_mask(a, b); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_epi64(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_epi64(a, b); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) { return _mm512_add_epi64(total, v); }
+		};
+		template <> struct Avx512<std::uint64_t> :Avx512Int {
+			using lane = std::uint64_t;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_epi64(std::int64_t(value)); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmpeq_epi64_mask(a, b); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_epu64(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_epu64(a, b); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) { return _mm512_add_epi64(total, v); }
+		};
+		template <> struct Avx512<float> {
+			using lane = float;
+			using vec = __m512;
+			using acc = __m512d;
+			static constexpr unsigned lanes = 16;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec load(const std::byte* p) { return _mm512_loadu_ps(p); }
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_ps(value); }
+			SEQ_TARGET("avx512f") static void store(lane* out, vec v) { _mm512_storeu_ps(out, v); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_ps(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_ps(a, b); }
+			SEQ_TARGET("avx512f") static acc zero() { return _mm512_setzero_pd(); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) {//the high half goes through the integer extract, the float one is AVX-512DQ
+				total = _mm512_add_pd(total, _mm512_cvtps_pd(_mm512_castps512_ps256(v)));
+				return _mm512_add_pd(total, _mm512_cvtps_pd(_mm256_castsi256_ps(_mm512_extracti64x4_epi64(_mm512_castps_si512(v), 1))));
+			}
+			SEQ_TARGET("avx512f") static void storeAcc(double* out, acc total) { _mm512_storeu_pd(out, total); }
+		};
+		template <> struct Avx512<double> {
+			using lane = double;
+			using vec = __m512d;
+			using acc = __m512d;
+			static constexpr unsigned lanes = 8;
+			static constexpr unsigned accLanes = 8;
+			SEQ_TARGET("avx512f") static vec load(const std::byte* p) { return _mm512_loadu_pd(p); }
+			SEQ_TARGET("avx512f") static vec set1(lane value) { return _mm512_set1_pd(value); }
+			SEQ_TARGET("avx512f") static void store(lane* out, vec v) { _mm512_storeu_pd(out, v); }
+			SEQ_TARGET("avx512f") static unsigned eq(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+			SEQ_TARGET("avx512f") static vec min(vec a, vec b) { return _mm512_min_pd(a, b); }
+			SEQ_TARGET("avx512f") static vec max(vec a, vec b) { return _mm512_max_pd(a, b); }
+			SEQ_TARGET("avx512f") static acc zero() { return _mm512_setzero_pd(); }
+			SEQ_TARGET("avx512f") static acc add(acc total, vec v) { return _mm512_add_pd(total, v); }
+			SEQ_TARGET("avx512f") static void storeAcc(double* out, acc total) { _mm512_storeu_pd(out, total); }
+		};
+#endif
+
+		//the kernels, one body for every level. always inlined into the entry functions below, which is where the instruction set
+		//is switched on, so nothing here may be called on its own. the main loops take 4 vectors a turn to hide compare/add latency
+		template <typename V>
+		struct Find {
+			using L = typename V::lane;
+			SEQ_INLINE static std::size_t run(const std::byte* p, std::size_t n, L value) {
+				constexpr std::size_t step = V::lanes * sizeof(L);
+				const auto needle = V::set1(value);
+				std::size_t i = 0;
+				for (; i + 4 * V::lanes <= n; i += 4 * V::lanes) {
+					const std::byte* block = p + i * sizeof(L);
+					const unsigned m0 = V::eq(V::load(block), needle);
+					const unsigned m1 = V::eq(V::load(block + step), needle);
+					const unsigned m2 = V::eq(V::load(block + 2 * step), needle);
+					const unsigned m3 = V::eq(V::load(block + 3 * step), needle);
+					if (m0 | m1 | m2 | m3) {
+						const std::uint64_t hits = m0 | (std::uint64_t(m1) << V::lanes) | (std::uint64_t(m2) << 2 * V::lanes) | (std::uint64_t(m3) << 3 * V::lanes);
+						return i + std::countr_zero(hits);
+					}
+				}
+				for (; i + V::lanes <= n; i += V::lanes) {
+					if (const unsigned hits = V::eq(V::load(p + i * sizeof(L)), needle))
+						return i + std::countr_zero(hits);
+				}
+				for (; i < n; i++) {
+					if (Scalar<L>::load(p + i * sizeof(L)) == value)
+						return i;
+				}
+				return n;
+			}
+		};
+		template <typename V>
+		struct Count {
+			using L = typename V::lane;
+			SEQ_INLINE static std::size_t run(const std::byte* p, std::size_t n, L value) {
+				const auto needle = V::set1(value);
+				std::size_t total = 0, i = 0;
+				for (; i + V::lanes <= n; i += V::lanes) {
+					const unsigned hits = V::eq(V::load(p + i * sizeof(L)), needle);
+					if constexpr (V::lanes <= 4)//sse2 has no popcnt instruction, a nibble table in a register is cheaper than the bit trick
+						total += (0x4332322132212110ull >> (hits * 4)) & 0xf;
+					else
+						total += std::popcount(hits);
+				}
+				for (; i < n; i++)
+					total += Scalar<L>::load(p + i * sizeof(L)) == value;
+				return total;
+			}
+		};
+		template <typename V>
+		struct MinMax {
+			using L = typename V::lane;
+			SEQ_INLINE static void run(const std::byte* p, std::size_t n, L* outLo, L* outHi) {//n > 0
+				constexpr std::size_t step = V::lanes * sizeof(L);
+				std::size_t i = 0;
+				L lo = Scalar<L>::load(p), hi = lo;
+				if (n >= 2 * V::lanes) {
+					auto lo0 = V::load(p), hi0 = lo0;
+					auto lo1 = V::load(p + step), hi1 = lo1;
+					for (i = 2 * V::lanes; i + 2 * V::lanes <= n; i += 2 * V::lanes) {
+						const auto v0 = V::load(p + i * sizeof(L));
+						const auto v1 = V::load(p + i * sizeof(L) + step);
+						lo0 = V::min(lo0, v0);
+						hi0 = V::max(hi0, v0);
+						lo1 = V::min(lo1, v1);
+						hi1 = V::max(hi1, v1);
+					}
+					L lanesLo[V::lanes], lanesHi[V::lanes];
+					V::store(lanesLo, V::min(lo0, lo1));
+					V::store(lanesHi, V::max(hi0, hi1));
+					for (unsigned k = 0; k < V::lanes; k++) {
+						lo = Scalar<L>::min(lo, lanesLo[k]);
+						hi = Scalar<L>::max(hi, lanesHi[k]);
+					}
+				}
+				for (; i < n; i++) {
+					const L value = Scalar<L>::load(p + i * sizeof(L));
+					lo = Scalar<L>::min(lo, value);
+					hi = Scalar<L>::max(hi, value);
+				}
+				*outLo = lo;
+				*outHi = hi;
+			}
+		};
+		template <typename V>
+		struct Sum {
+			using L = typename V::lane;
+			SEQ_INLINE static sum_t<L> run(const std::byte* p, std::size_t n) {
+				constexpr std::size_t step = V::lanes * sizeof(L);
+				auto acc0 = V::zero(), acc1 = V::zero(), acc2 = V::zero(), acc3 = V::zero();
+				std::size_t i = 0;
+				for (; i + 4 * V::lanes <= n; i += 4 * V::lanes) {
+					const std::byte* block = p + i * sizeof(L);
+					acc0 = V::add(acc0, V::load(block));
+					acc1 = V::add(acc1, V::load(block + step));
+					acc2 = V::add(acc2, V::load(block + 2 * step));
+					acc3 = V::add(acc3, V::load(block + 3 * step));
+				}
+				for (; i + V::lanes <= n; i += V::lanes)
+					acc0 = V::add(acc0, V::load(p + i * sizeof(L)));
+				sum_t<L> lanes0[V::accLanes], lanes1[V::accLanes], lanes2[V::accLanes], lanes3[V::accLanes];
+				V::storeAcc(lanes0, acc0);
+				V::storeAcc(lanes1, acc1);
+				V::storeAcc(lanes2, acc2);
+				V::storeAcc(lanes3, acc3);
+				sum_t<L> total = 0;
+				for (unsigned k = 0; k < V::accLanes; k++)
+					total = wrapAdd(total, wrapAdd(wrapAdd(lanes0[k], lanes1[k]), wrapAdd(lanes2[k], lanes3[k])));
+				for (; i < n; i++)
+					total = wrapAdd(total, sum_t<L>(Scalar<L>::load(p + i * sizeof(L))));
+				return total;
+			}
+		};
+		template <typename V>
+		struct Equal {
+			using L = typename V::lane;
+			SEQ_INLINE static bool run(const std::byte* a, const std::byte* b, std::size_t n) {
+				constexpr unsigned all = unsigned((std::uint64_t(1) << V::lanes) - 1);
+				std::size_t i = 0;
+				for (; i + V::lanes <= n; i += V::lanes) {
+					if (V::eq(V::load(a + i * sizeof(L)), V::load(b + i * sizeof(L))) != all)
+						return false;
+				}
+				for (; i < n; i++) {
+					if (!(Scalar<L>::load(a + i * sizeof(L)) == Scalar<L>::load(b + i * sizeof(L))))
+						return false;
+				}
+				return true;
+			}
+		};
+
+		//entry points: where each level's instruction set is actually enabled
+		template <template <typename> class Kernel, typename L, typename... Args>
+		auto onScalar(Args... args) { return Kernel<Scalar<L>>::run(args...); }
+#if defined(SEQ_SIMD_X86)
+		template <template <typename> class Kernel, typename L, typename... Args>
+		SEQ_TARGET("sse2") auto onSse2(Args... args) { return Kernel<Sse2<L>>::run(args...); }
+		template <template <typename> class Kernel, typename L, typename... Args>
+		SEQ_TARGET("avx2") auto onAvx2(Args... args) { return Kernel<Avx2<L>>::run(args...); }
+		template <template <typename> class Kernel, typename L, typename... Args>
+		SEQ_TARGET("avx512f") auto onAvx512(Args... args) { return Kernel<Avx512<L>>::run(args...); }
+#endif
+
+		template <template <typename> class Kernel, typename L, typename... Args>
+		auto dispatch(Args... args) {
+#if defined(SEQ_SIMD_X86)
+			switch (activeLevel()) {
+			case Level::avx512: return onAvx512<Kernel, L>(args...);
+			case Level::avx2:   return onAvx2<Kernel, L>(args...);
+			case Level::sse2:   return onSse2<Kernel, L>(args...);
+			default:            break;
+			}
+#endif
+			return onScalar<Kernel, L>(args...);
+		}
+	}
+
+	namespace {
+		//stream compaction doesn't fit the traits shape, the predicate already ran in the header and left one keep flag per element.
+		//every variant writes a full element or vector at the current output end whatever the flags, output never passes input
+		//so those stores only land on consumed slots
+		template <std::size_t Bytes>
+		SEQ_INLINE std::size_t compactScalar(std::byte* out, const std::byte* in, std::size_t from, std::size_t count, const bool* keep) {
+			std::size_t kept = 0;
+			for (std::size_t i = from; i < count; i++) {
+				std::memmove(out + kept * Bytes, in + i * Bytes, Bytes);
+				kept += keep[i];
+			}
+			return kept;
+		}
+#if defined(SEQ_SIMD_X86)
+		//8 x 32bit lanes: entry[mask] lists the kept lane indices first, one byte each
+		constexpr std::array<std::uint64_t, 256> compactLut = [] {
+			std::array<std::uint64_t, 256> table{};
+			for (unsigned mask = 0; mask < 256; mask++) {
+				std::uint64_t entry = 0;
+				unsigned slot = 0;
+				for (unsigned lane = 0; lane < 8; lane++) {
+					if (mask & (1u << lane)) {
+						entry |= std::uint64_t(lane) << (slot * 8);
+						++slot;
+					}
+				}
+				table[mask] = entry;
+			}
+			return table;
+		}();
+		SEQ_TARGET("avx2") SEQ_INLINE unsigned flagMask32(const bool* keep) {//0/1 bytes -> bits, the flag lands in each sign bit
+			return unsigned(_mm256_movemask_epi8(_mm256_slli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keep)), 7)));
+		}
+		template <std::size_t Bytes>
+		SEQ_TARGET("avx2") std::size_t compactAvx2(std::byte* out, const std::byte* in, std::size_t count, const bool* keep) {
+			constexpr unsigned lanes = 32 / Bytes;
+			std::size_t kept = 0, i = 0;
+			for (; i + 32 <= count; i += 32) {
+				unsigned flags = flagMask32(keep + i);
+				for (unsigned block = 0; block < 32; block += lanes, flags >>= lanes) {
+					const unsigned mask = flags & ((1u << lanes) - 1);
+					//a 64bit lane is a pair of 32bit ones, kept together: 0b0101 -> 0b00110011
+					const unsigned pairs = Bytes == 4 ? mask : ((mask & 1) | (mask & 2) << 1 | (mask & 4) << 2 | (mask & 8) << 3) * 3;
+					const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + (i + block) * Bytes));
+					const __m256i order = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&compactLut[pairs])));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + kept * Bytes), _mm256_permutevar8x32_epi32(values, order));
+					kept += std::popcount(mask);
+				}
+			}
+			return kept + compactScalar<Bytes>(out + kept * Bytes, in, i, count, keep);
+		}
+		template <std::size_t Bytes>
+		SEQ_TARGET("avx512f") std::size_t compactAvx512(std::byte* out, const std::byte* in, std::size_t count, const bool* keep) {
+			constexpr unsigned lanes = 64 / Bytes;
+			std::size_t kept = 0, i = 0;
+			for (; i + 32 <= count; i += 32) {
+				unsigned flags = flagMask32(keep + i);
+				for (unsigned block = 0; block < 32; block += lanes, flags >>= lanes) {
+					const unsigned mask = flags & ((1u << lanes) - 1);
+					const __m512i values = _mm512_loadu_si512(in + (i + block) * Bytes);
+					if constexpr (Bytes == 4)
+						_mm512_mask_compressstoreu_epi32(out + kept * Bytes, __mmask16(mask), values);
+					else
+						_mm512_mask_compressstoreu_epi64(out + kept * Bytes, __mmask8(mask), values);
+					kept += std::popcount(mask);
+				}
+			}
+			return kept + compactScalar<Bytes>(out + kept * Bytes, in, i, count, keep);
+		}
+#endif
+	}
+
+	namespace detail {
+		template <typename L>
+		std::size_t findIndex(const void* data, std::size_t count, L value)noexcept {
+			return dispatch<Find, L>(static_cast<const std::byte*>(data), count, value);
+		}
+		template <typename L>
+		std::size_t countEqual(const void* data, std::size_t count, L value)noexcept {
+			return dispatch<Count, L>(static_cast<const std::byte*>(data), count, value);
+		}
+		template <typename L>
+		void minMax(const void* data, std::size_t count, L& lo, L& hi)noexcept {
+			dispatch<MinMax, L>(static_cast<const std::byte*>(data), count, &lo, &hi);
+		}
+		template <typename L>
+		sum_t<L> sum(const void* data, std::size_t count)noexcept {
+			return dispatch<Sum, L>(static_cast<const std::byte*>(data), count);
+		}
+		template <typename L>
+		bool equal(const void* lhs, const void* rhs, std::size_t count)noexcept {
+			return dispatch<Equal, L>(static_cast<const std::byte*>(lhs), static_cast<const std::byte*>(rhs), count);
+		}
+
+		template <std::size_t Bytes>
+		std::size_t compactFlagged(void* out, const void* data, std::size_t count, const bool* keep)noexcept {
+			std::byte* to = static_cast<std::byte*>(out);
+			const std::byte* from = static_cast<const std::byte*>(data);
+#if defined(SEQ_SIMD_X86)
+			switch (activeLevel()) {
+			case Level::avx512: return compactAvx512<Bytes>(to, from, count, keep);
+			case Level::avx2:   return compactAvx2<Bytes>(to, from, count, keep);
+			default:            break;//sse2 has no lane permute worth the table
+			}
+#endif
+			return compactScalar<Bytes>(to, from, 0, count, keep);
+		}
+
+		template std::size_t findIndex<std::int32_t>(const void*, std::size_t, std::int32_t)noexcept;
+		template std::size_t findIndex<std::uint32_t>(const void*, std::size_t, std::uint32_t)noexcept;
+		template std::size_t findIndex<std::int64_t>(const void*, std::size_t, std::int64_t)noexcept;
+		template std::size_t findIndex<std::uint64_t>(const void*, std::size_t, std::uint64_t)noexcept;
+		template std::size_t findIndex<float>(const void*, std::size_t, float)noexcept;
+		template std::size_t findIndex<double>(const void*, std::size_t, double)noexcept;
+
+		template std::size_t countEqual<std::int32_t>(const void*, std::size_t, std::int32_t)noexcept;
+		template std::size_t countEqual<std::uint32_t>(const void*, std::size_t, std::uint32_t)noexcept;
+		template std::size_t countEqual<std::int64_t>(const void*, std::size_t, std::int64_t)noexcept;
+		template std::size_t countEqual<std::uint64_t>(const void*, std::size_t, std::uint64_t)noexcept;
+		template std::size_t countEqual<float>(const void*, std::size_t, float)noexcept;
+		template std::size_t countEqual<double>(const void*, std::size_t, double)noexcept;
+
+		template void minMax<std::int32_t>(const void*, std::size_t, std::int32_t&, std::int32_t&)noexcept;
+		template void minMax<std::uint32_t>(const void*, std::size_t, std::uint32_t&, std::uint32_t&)noexcept;
+		template void minMax<std::int64_t>(const void*, std::size_t, std::int64_t&, std::int64_t&)noexcept;
+		template void minMax<std::uint64_t>(const void*, std::size_t, std::uint64_t&, std::uint64_t&)noexcept;
+		template void minMax<float>(const void*, std::size_t, float&, float&)noexcept;
+		template void minMax<double>(const void*, std::size_t, double&, double&)noexcept;
+
+		template sum_t<std::int32_t> sum<std::int32_t>(const void*, std::size_t)noexcept;
+		template sum_t<std::uint32_t> sum<std::uint32_t>(const void*, std::size_t)noexcept;
+		template sum_t<std::int64_t> sum<std::int64_t>(const void*, std::size_t)noexcept;
+		template sum_t<std::uint64_t> sum<std::uint64_t>(const void*, std::size_t)noexcept;
+		template sum_t<float> sum<float>(const void*, std::size_t)noexcept;
+		template sum_t<double> sum<double>(const void*, std::size_t)noexcept;
+
+		template bool equal<float>(const void*, const void*, std::size_t)noexcept;
+		template bool equal<double>(const void*, const void*, std::size_t)noexcept;
+
+		template std::size_t compactFlagged<4>(void*, const void*, std::size_t, const bool*)noexcept;
+		template std::size_t compactFlagged<8>(void*, const void*, std::size_t, const bool*)noexcept;
+	}
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace seq::simd {
+	//instruction sets the search and reduction kernels below dispatch between at run time, ordered, each one implies the ones before
+	enum class Level : unsigned char { scalar, sse2, avx2, avx512 };
+
+	Level detectedLevel()noexcept;//best the cpu and the os both support, from cpuid once
+	Level activeLevel()noexcept;
+	Level setLevel(Level level)noexcept;//caps dispatch at level, clamped to detectedLevel(). returns what's in effect, for benchmarks and tests
+	const char* levelName(Level level)noexcept;
+
+	//what sum() adds up in: 64bit integers (wrapping like them) and double for float, so a million ints doesn't overflow an int
+	template <typename T>
+	using sum_t = std::conditional_t<std::is_floating_point_v<T>, std::conditional_t<(sizeof(T) > sizeof(double)), T, double>,
+		std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+	namespace detail {
+		//lane type of the kernel T runs through, void when there is none. int/long/long long etc. collapse to their fixed width twin
+		template <typename T>
+		using lane_t = std::conditional_t<std::is_same_v<T, float> || std::is_same_v<T, double>, T,
+			std::conditional_t<!std::is_integral_v<T> || std::is_same_v<T, bool> || (sizeof(T) != 4 && sizeof(T) != 8), void,
+			std::conditional_t<sizeof(T) == 4, std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>,
+				std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>>>;
+		template <typename T>
+		inline constexpr bool has_kernel = !std::is_void_v<lane_t<T>>;
+
+		//defined in Simd.cpp for the six lane types, data is read bytewise so any same sized T may be passed in
+		template <typename L> std::size_t findIndex(const void* data, std::size_t count, L value)noexcept;
+		template <typename L> std::size_t countEqual(const void* data, std::size_t count, L value)noexcept;
+		template <typename L> void minMax(const void* data, std::size_t count, L& lo, L& hi)noexcept;
+		template <typename L> sum_t<L> sum(const void* data, std::size_t count)noexcept;
+		template <typename L> bool equal(const void* lhs, const void* rhs, std::size_t count)noexcept;
+
+		//keep[i] is 1 for the survivors and 0 for the rest, they are written to out in order, out may be data or anything below it.
+		//returns how many. defined in Simd.cpp for 4 and 8 byte elements
+		template <std::size_t Bytes> std::size_t compactFlagged(void* out, const void* data, std::size_t count, const bool* keep)noexcept;
+	}
+
+	//order preserving stream compaction: drops every element pred says yes to, survivors slide down, returns the new end.
+	//the dropped tail is left as is (it's arithmetic, nothing to destroy). pred runs inline over a batch into one flag per element, the
+	//compaction itself dispatches at run time like the kernels below: compress stores on AVX-512, a permute table on AVX2,
+	//a branchless scalar loop otherwise and for element sizes other than 4 and 8
+	template <typename T, typename Pred>
+	inline T* compact(T* first, T* last, Pred pred) {
+		static_assert(std::is_arithmetic_v<T>, "compact is for arithmetic types, use std::remove_if for the rest");
+		T* out = first;
+		if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+			constexpr std::size_t batch = 256;
+			bool keep[batch];
+			for (; last - first >= std::ptrdiff_t(batch); first += batch) {
+				for (std::size_t i = 0; i < batch; i++)//fixed trip count into a local, simple predicates get vectorized even at -O2
+					keep[i] = !pred(first[i]);
+				out += detail::compactFlagged<sizeof(T)>(out, first, batch, keep);
+			}
+			const std::size_t rest = std::size_t(last - first);
+			for (std::size_t i = 0; i < rest; i++)
+				keep[i] = !pred(first[i]);
+			out += detail::compactFlagged<sizeof(T)>(out, first, rest, keep);
+		}
+		else {
+			for (; first != last; ++first) {
+				*out = *first;
+				out += !pred(*out);
+			}
+		}
+		return out;
+	}
+
+	//search and reductions. float compares follow ==: NaN matches nothing and 0.0 finds -0.0. with a NaN in the range min_max is unspecified.
+	//sum adds in a different order than a left to right loop, floating results can differ from one in the last bits
+	template <typename T> requires std::is_arithmetic_v<T>
+	const T* find(const T* first, const T* last, T value)noexcept {
+		if constexpr (detail::has_kernel<T>) {
+			using lane = detail::lane_t<T>;
+			return first + detail::findIndex<lane>(first, last - first, lane(value));
+		}
+		else {
+			return std::find(first, last, value);
+		}
+	}
+	template <typename T> requires std::is_arithmetic_v<T>
+	std::size_t count(const T* first, const T* last, T value)noexcept {
+		if constexpr (detail::has_kernel<T>) {
+			using lane = detail::lane_t<T>;
+			return detail::countEqual<lane>(first, last - first, lane(value));
+		}
+		else {
+			return std::size_t(std::count(first, last, value));
+		}
+	}
+	template <typename T> requires std::is_arithmetic_v<T>
+	bool contains(const T* first, const T* last, T value)noexcept {
+		return find(first, last, value) != last;
+	}
+	template <typename T> requires std::is_arithmetic_v<T>
+	std::ranges::min_max_result<T> min_max(const T* first, const T* last)noexcept {
+		assert(first != last && "min_max of an empty range");
+		if constexpr (detail::has_kernel<T>) {
+			using lane = detail::lane_t<T>;
+			lane lo, hi;
+			detail::minMax<lane>(first, last - first, lo, hi);
+			return { T(lo), T(hi) };
+		}
+		else {
+			const auto [lo, hi] = std::minmax_element(first, last);
+			return { *lo, *hi };
+		}
+	}
+	template <typename T> requires std::is_arithmetic_v<T>
+	sum_t<T> sum(const T* first, const T* last)noexcept {
+		if constexpr (detail::has_kernel<T>) {
+			return sum_t<T>(detail::sum<detail::lane_t<T>>(first, last - first));
+		}
+		else {
+			sum_t<T> total = 0;
+			for (; first != last; ++first)
+				total += sum_t<T>(*first);
+			return total;
+		}
+	}
+	//integers have no padding and one representation per value, so equal bytes is equal values and memcmp (already vectorized) does it.
+	//floating point can't, 0.0 == -0.0 and NaN != NaN, those go through a compare kernel
+	template <typename T> requires std::is_arithmetic_v<T>
+	bool equal(const T* first, const T* last, const T* other)noexcept {
+		if (first == last)
+			return true;
+		if constexpr (std::is_integral_v<T>) {
+			return std::memcmp(first, other, (last - first) * sizeof(T)) == 0;
+		}
+		else if constexpr (detail::has_kernel<T>) {
+			return detail::equal<detail::lane_t<T>>(first, other, last - first);
+		}
+		else {
+			return std::equal(first, last, other);
+		}
+	}
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "Sequence.h"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace seq {
+	//stable name of a SlotMap element: which slot, and which occupant of that slot. a handle whose element was erased
+	//stays harmless forever, the slot's generation moved on and lookups with the old one just miss
+	struct SlotHandle {
+		std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+		std::uint32_t generation = 0;//odd while the slot is occupied, so the default (0) never matches anything
+
+		constexpr bool isNull()const noexcept { return generation == 0; }
+		friend constexpr bool operator==(const SlotHandle&, const SlotHandle&) = default;
+	};
+
+	//values packed into one Sequence for scans, plus a sparse slot table that maps handles to their current position.
+	//insert, erase and lookup are O(1): erase moves the last value into the hole (Sequence::remove) and repoints the slot
+	//of the value that moved, so handles survive what indices and pointers don't. iteration order is arbitrary and changes
+	//with every erase, iterators and references die with any modification, handles only with the erase of their element
+	template <typename T, typename Allocator = std::allocator<T>>
+	class SlotMap {
+	private:
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>, "Allocator::value_type must be T");
+		static_assert(strong_movable<T>, "T must be nothrow movable, erase moves the last element into the hole");
+
+		struct Slot {
+			std::uint32_t dense;     //position of the value while occupied, next free slot while free
+			std::uint32_t generation;//even while free
+		};
+		using slot_allocator  = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+		using index_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+
+		static constexpr std::uint32_t noSlot = std::numeric_limits<std::uint32_t>::max();
+	public:
+		//type names
+		using type                 = SlotMap<T, Allocator>;
+		using value_type           = T;
+		using allocator_type       = Allocator;
+		using handle_type          = SlotHandle;
+		using pointer              = T*;
+		using const_pointer        = const T*;
+		using reference            = T&;
+		using const_reference      = const T&;
+		using size_type            = std::size_t;
+		using difference_type      = std::ptrdiff_t;
+		using value_container_type = Sequence<T, Allocator>;
+
+		using iterator             = typename value_container_type::iterator;
+		using const_iterator       = typename value_container_type::const_iterator;
+		//#################################################
+
+	private:
+		//the important shit
+		const Slot* liveSlot(handle_type handle)const noexcept {
+			if (handle.index >= slots.size())
+				return nullptr;
+			const Slot& slot = slots[handle.index];
+			return slot.generation == handle.generation && (slot.generation & 1) ? &slot : nullptr;
+		}
+		std::uint32_t acquireSlot() {//a free slot, or a new one. the slot is not marked occupied yet
+			if (freeHead != noSlot)
+				return freeHead;
+			if (slots.size() >= noSlot)
+				throw std::length_error("SlotMap: out of handles");
+			slots.push_back(Slot{ noSlot, 0 });
+			freeHead = std::uint32_t(slots.size() - 1);
+			return freeHead;
+		}
+		void releaseSlot(std::uint32_t index)noexcept {//occupied -> free. a slot whose generation would wrap is retired, never reused
+			Slot& slot = slots[index];
+			++slot.generation;
+			if (slot.generation == std::numeric_limits<std::uint32_t>::max() - 1) {
+				slot.dense = noSlot;
+				return;
+			}
+			slot.dense = freeHead;
+			freeHead = index;
+		}
+		void eraseDense(std::uint32_t at)noexcept {//remove the value at, the last one takes its place
+			const std::uint32_t last = std::uint32_t(values.size() - 1);
+			if (at != last)
+				slots[owners[last]].dense = at;
+			values.remove(values.begin() + at);
+			owners.remove(owners.begin() + at);
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		SlotMap() = default;
+		explicit SlotMap(const allocator_type& allocator) :values(allocator), owners(index_allocator(allocator)), slots(slot_allocator(allocator)) {}
+		SlotMap(const SlotMap&) = default;
+		SlotMap(SlotMap&& rhs)noexcept :values(std::move(rhs.values)), owners(std::move(rhs.owners)), slots(std::move(rhs.slots)),
+			freeHead(std::exchange(rhs.freeHead, noSlot)) {}//the free list lives in the slots, it has to leave with them
+		SlotMap& operator=(const SlotMap&) = default;
+		SlotMap& operator=(SlotMap&& rhs)noexcept(std::is_nothrow_move_assignable_v<value_container_type>) {
+			if (this == &rhs)
+				return *this;
+			values = std::move(rhs.values);
+			owners = std::move(rhs.owners);
+			slots = std::move(rhs.slots);
+			freeHead = std::exchange(rhs.freeHead, noSlot);
+			return *this;
+		}
+		//#################################################
+
+		//ACCESS
+		pointer find(handle_type handle)noexcept {
+			const Slot* slot = liveSlot(handle);
+			return slot ? values.data() + slot->dense : nullptr;
+		}
+		const_pointer find(handle_type handle)const noexcept {
+			const Slot* slot = liveSlot(handle);
+			return slot ? values.data() + slot->dense : nullptr;
+		}
+		bool contains(handle_type handle)const noexcept {
+			return liveSlot(handle);
+		}
+		reference at(handle_type handle) {
+			if (pointer value = find(handle))
+				return *value;
+			throw std::out_of_range("stale or foreign handle");
+		}
+		const_reference at(handle_type handle)const {
+			if (const_pointer value = find(handle))
+				return *value;
+			throw std::out_of_range("stale or foreign handle");
+		}
+		reference operator[](handle_type handle) {
+			assert(contains(handle));
+			return values[slots[handle.index].dense];
+		}
+		const_reference operator[](handle_type handle)const {
+			assert(contains(handle));
+			return values[slots[handle.index].dense];
+		}
+		handle_type handle_at(size_type pos)const {//handle of the value at a dense position, e.g. from an iterator: it - begin()
+			if (pos >= values.size())
+				throw std::out_of_range("position out of range");
+			const std::uint32_t slot = owners[pos];
+			return { slot, slots[slot].generation };
+		}
+		handle_type handle_of(const_iterator pos)const {
+			return handle_at(size_type(pos - values.cbegin()));
+		}
+
+		//the packed values, a plain Sequence scan: SIMD sum/find/min_max through the view, hand the span to Parallel.h...
+		SequenceView<value_type>       view()noexcept        { return values.view(); }
+		SequenceView<const value_type> view()const noexcept  { return values.view(); }
+		pointer        data()noexcept           { return values.data(); }
+		const_pointer  data()const noexcept     { return values.data(); }
+
+		iterator       begin()                  { return values.begin(); }
+		iterator       end()                    { return values.end(); }
+		const_iterator begin()const             { return values.begin(); }
+		const_iterator end()const               { return values.end(); }
+		const_iterator cbegin()const            { return values.cbegin(); }
+		const_iterator cend()const              { return values.cend(); }
+		//#################################################
+
+		//MODIFICATION
+		template <typename... Args>
+		handle_type emplace(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			const std::uint32_t index = acquireSlot();
+			values.emplace_back(std::forward<Args>(args)...);
+			try {
+				owners.push_back(index);
+			}
+			catch (...) {
+				values.pop_back();
+				throw;
+			}
+			Slot& slot = slots[index];
+			freeHead = slot.dense;
+			slot.dense = std::uint32_t(values.size() - 1);
+			++slot.generation;
+			return { index, slot.generation };
+		}
+		handle_type insert(const_reference value) requires std::copyable<value_type> {
+			return emplace(value);
+		}
+		handle_type insert(value_type&& value) {
+			return emplace(std::move(value));
+		}
+		bool erase(handle_type handle)noexcept {//false for stale handles, erasing twice is harmless
+			const Slot* slot = liveSlot(handle);
+			if (!slot)
+				return false;
+			eraseDense(slot->dense);
+			releaseSlot(handle.index);
+			return true;
+		}
+		iterator erase(const_iterator pos) {//the last value lands at pos, so a forward loop doesn't advance after an erase
+			const size_type at = size_type(pos - values.cbegin());
+			if (at >= values.size())
+				throw std::out_of_range("position out of range");
+			const std::uint32_t slot = owners[at];
+			eraseDense(std::uint32_t(at));
+			releaseSlot(slot);
+			return values.begin() + at;
+		}
+		template <typename UnaryPred>
+		size_type erase_if(UnaryPred predicate) requires std::predicate<UnaryPred&, const_reference> {
+			const size_type oldSize = values.size();
+			for (size_type i = oldSize; i-- > 0;) {//backwards, whatever moves into i was already tested
+				if (predicate(std::as_const(values[i]))) {
+					const std::uint32_t slot = owners[i];
+					eraseDense(std::uint32_t(i));
+					releaseSlot(slot);
+				}
+			}
+			return oldSize - values.size();
+		}
+		void clear()noexcept {//every handle goes stale, the slots stay for reuse
+			for (std::uint32_t slot : owners)
+				releaseSlot(slot);
+			values.clear();
+			owners.clear();
+		}
+		void swap(SlotMap& rhs)noexcept {
+			values.swap(rhs.values);
+			owners.swap(rhs.owners);
+			slots.swap(rhs.slots);
+			std::swap(freeHead, rhs.freeHead);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept   { return values.isEmpty(); }
+		size_type size()const noexcept      { return values.size(); }
+		size_type slot_count()const noexcept { return slots.size(); }//high water mark, slots are recycled but never returned
+		allocator_type get_allocator()const noexcept { return values.get_allocator(); }
+
+		void reserve(size_type newCap) {
+			values.reserve(newCap);
+			owners.reserve(newCap);
+			slots.reserve(newCap);
+		}
+		void shrinkToFit() {
+			values.shrinkToFit();
+			owners.shrinkToFit();
+		}
+		//#################################################
+	private:
+		//members
+		value_container_type values;
+		Sequence<std::uint32_t, index_allocator> owners;//owners[i] is the slot pointing at values[i]
+		Sequence<Slot, slot_allocator> slots;
+		std::uint32_t freeHead = noSlot;
+	};
+
+	template <typename T, typename Allocator>
+	void swap(SlotMap<T, Allocator>& lhs, SlotMap<T, Allocator>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
+
+template <>
+struct std::hash<seq::SlotHandle> {
+	std::size_t operator()(const seq::SlotHandle& handle)const noexcept {
+		return std::hash<std::uint64_t>()(std::uint64_t(handle.generation) << 32 | handle.index);
+	}
+};
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "Sequence.h"
+#include <cstddef>
+
+namespace seq {
+	//Sequence with the first N elements stored inline. no heap is touched until size goes past N,
+	//after that it behaves exactly like Sequence. shrinkToFit pulls the elements back inline once they fit again
+	template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+	class SmallSequence {
+	private:
+		static_assert(N > 0, "N must be at least 1, use Sequence for no inline storage");
+		static_assert(std::is_object_v<T>, "T must be an object type");
+		static_assert(std::destructible<T>, "T must be destructible");
+		static_assert(!std::is_const_v<T>, "T cannot be const type");
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>, "Allocator::value_type must be T");
+
+		static constexpr std::size_t first_index = 0;
+	public:
+		//type names
+		using type            = SmallSequence<T, N, Allocator>;
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = typename Sequence<T, Allocator>::iterator;//same pointer wrappers, so generic code written against Sequence works unchanged
+		using const_iterator  = typename Sequence<T, Allocator>::const_iterator;
+
+		static constexpr size_type inline_capacity = N;
+		//#################################################
+
+	private:
+		using alloc_traits    = std::allocator_traits<allocator_type>;
+
+		//the important shit
+		void tryReAllocate(size_type count) {//moves everything into a fresh heap block of count
+			pointer moved = memAlloc(count);
+			try {
+				relocateInto(moved);
+			}
+			catch (...) {
+				memDealloc(moved, count);
+				throw;
+			}
+			memFreeHeap();
+			array = moved;
+			cap = count;
+		}
+		void relocateInto(pointer dest) {//elements end up at dest, source range destroyed. on throw dest is clean and the source untouched
+			pointer begin = raw_begin();
+			pointer end = raw_end();
+			if constexpr (is_trivially_relocatable_v<value_type>) {
+				if (mSize > 0)
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(begin), mSize * sizeof(value_type));
+				return;
+			}
+			pointer initialized = dest;
+			try {
+				if constexpr (std::is_nothrow_move_constructible_v<value_type>) {
+					initialized = std::uninitialized_move(begin, end, dest);
+				}
+				else {
+					initialized = std::uninitialized_copy(begin, end, dest);
+				}
+			}
+			catch (...) {
+				std::destroy(dest, initialized);
+				throw;
+			}
+			std::destroy(begin, end);
+		}
+		template <typename Construct>
+		void tryElemConstruct(size_type count, Construct construct) {//only from an empty inline state (constructors)
+			if (count > N) {
+				array = memAlloc(count);
+				cap = count;
+			}
+			pointer initalizedTail = array;
+			try {
+				initalizedTail = construct(array, count);
+				mSize = count;
+			}
+			catch (...) {
+				std::destroy(array, initalizedTail);
+				memFreeHeap();
+				throw;
+			}
+		}
+		//#################################################
+
+		//the convenience
+		pointer memAlloc(size_type count) {
+			return std::to_address(alloc_traits::allocate(alloc, count));
+		}
+		void memDealloc(pointer p, size_type count)noexcept {
+			alloc_traits::deallocate(alloc, p, count);
+		}
+		void memFreeHeap()noexcept {//back to the inline buffer, elements must already be gone or relocated
+			if (!isInline()) {
+				memDealloc(array, cap);
+				array = inlineData();
+				cap = N;
+			}
+		}
+		void objDestroyAll()noexcept {
+			if (mSize > 0) {
+				std::destroy(raw_begin(), raw_end());
+				mSize = 0;
+			}
+		}
+		void takeFrom(SmallSequence& rhs) {//*this must be empty, leaves rhs empty
+			if (!rhs.isInline() && alloc == rhs.alloc) {
+				memFreeHeap();
+				array = std::exchange(rhs.array, rhs.inlineData());
+				mSize = std::exchange(rhs.mSize, 0);
+				cap = std::exchange(rhs.cap, N);
+				return;
+			}
+			reserve(rhs.mSize);
+			rhs.relocateInto(raw_begin());
+			mSize = std::exchange(rhs.mSize, 0);
+		}
+		pointer inlineData()noexcept                           { return reinterpret_cast<pointer>(buffer); }
+		constexpr pointer raw_begin()                          { return array; }
+		constexpr pointer raw_end()                            { return array + mSize; }
+		constexpr size_type growthFactor(size_type input)const { return input + (input / 2) + 1; }
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		SmallSequence()noexcept(std::is_nothrow_default_constructible_v<allocator_type>) requires std::default_initializable<allocator_type> {}
+		explicit SmallSequence(const allocator_type& allocator)noexcept :alloc(allocator) {}
+		SmallSequence(size_type count, const allocator_type& allocator = allocator_type()) requires std::default_initializable<value_type> :alloc(allocator) {
+			tryElemConstruct(count, [](pointer p, size_type n) {
+				return std::uninitialized_value_construct_n(p, n);
+				}
+			);
+		}
+		SmallSequence(size_type count, const_reference value, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type> :alloc(allocator) {
+			tryElemConstruct(count, [&value](pointer p, size_type n) {
+				return std::uninitialized_fill_n(p, n, value);
+				}
+			);
+		}
+		SmallSequence(std::initializer_list<value_type> init, const allocator_type& allocator = allocator_type()) requires std::copyable<value_type> :alloc(allocator) {
+			tryElemConstruct(init.size(), [init](pointer p, size_type) {
+				return std::uninitialized_copy(init.begin(), init.end(), p);
+				}
+			);
+		}
+		SmallSequence(const SmallSequence& rhs) requires std::copyable<value_type>
+			:alloc(alloc_traits::select_on_container_copy_construction(rhs.alloc)) {
+			tryElemConstruct(rhs.size(), [&rhs](pointer p, size_type) {
+				return std::uninitialized_copy(rhs.begin(), rhs.end(), p);
+				}
+			);
+		}
+		SmallSequence(SmallSequence&& rhs)noexcept requires strong_movable<value_type> :alloc(rhs.alloc) {//inline elements have to walk over, heap is stolen
+			takeFrom(rhs);
+		}
+		SmallSequence& operator=(const SmallSequence& rhs) requires std::copyable<value_type> {
+			if (this == &rhs)
+				return *this;
+			SmallSequence temp(rhs);
+			objDestroyAll();
+			takeFrom(temp);
+			return *this;
+		}
+		SmallSequence& operator=(SmallSequence&& rhs) requires strong_movable<value_type> {
+			if (this == &rhs)
+				return *this;
+			objDestroyAll();
+			takeFrom(rhs);
+			return *this;
+		}
+		SmallSequence& operator=(std::initializer_list<value_type> ilist) requires std::copyable<value_type> {
+			SmallSequence temp(ilist, alloc);
+			objDestroyAll();
+			takeFrom(temp);
+			return *this;
+		}
+		~SmallSequence()noexcept {
+			objDestroyAll();
+			memFreeHeap();
+		}
+		//#################################################
+
+		//ACCESS
+		constexpr reference front() {
+			assert(mSize > first_index);
+			return array[first_index];
+		}
+		constexpr const_reference front()const {
+			assert(mSize > first_index);
+			return array[first_index];
+		}
+		constexpr reference back() {
+			assert(mSize > first_index);
+			return array[mSize - 1];
+		}
+		constexpr const_reference back()const {
+			assert(mSize > first_index);
+			return array[mSize - 1];
+		}
+		constexpr reference operator[](size_type index) {
+			assert(index < mSize);
+			return array[index];
+		}
+		constexpr const_reference operator[](size_type index)const {
+			assert(index < mSize);
+			return array[index];
+		}
+		constexpr reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return array[pos];
+		}
+		constexpr const_reference at(size_type pos)const {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return array[pos];
+		}
+		constexpr pointer        data()noexcept           { return   array; }
+		constexpr const_pointer  data()const noexcept     { return   array; }
+
+		constexpr iterator       begin()                  { return { array }; }
+		constexpr iterator       end()                    { return { array + mSize }; }
+		constexpr const_iterator begin()const             { return { array }; }
+		constexpr const_iterator end()const               { return { array + mSize }; }
+		constexpr const_iterator cbegin()const            { return { array }; }
+		constexpr const_iterator cend()const              { return { array + mSize }; }
+		//#################################################
+
+		//MODIFICATION
+		template <typename U>
+		void push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {//implicit copy or move requirement
+			if (mSize == cap)
+				tryReAllocate(growthFactor(cap));
+			std::construct_at(raw_end(), std::forward<U>(value));
+			++mSize;
+		}
+		template<typename... Args> void emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			if (mSize == cap)
+				tryReAllocate(growthFactor(cap));
+			std::construct_at(raw_end(), std::forward<Args>(args)...);//safe to throw on fail, array not modified
+			++mSize;
+		}
+		void pop_back()noexcept {
+			if (mSize > 0) {
+				std::destroy_at(raw_end() - 1);
+				--mSize;
+			}
+		}
+		iterator erase(iterator pos)requires strong_movable<value_type> {
+			pointer eraseElem = pos.base();
+			pointer arrayBegin = raw_begin();
+			pointer arrayEnd = raw_end();
+			if (eraseElem < arrayBegin || eraseElem > arrayEnd) throw std::out_of_range("position out of range");
+			if (eraseElem == arrayEnd) return arrayEnd;
+
+			std::move(eraseElem + 1, arrayEnd, eraseElem);
+			--arrayEnd;
+			std::destroy_at(arrayEnd);
+			--mSize;
+
+			return eraseElem;
+		}
+		iterator erase(iterator first, iterator last)requires strong_movable<value_type> {
+			pointer eraseFirst = first.base();
+			pointer eraseLast = last.base();
+			pointer arrayBegin = raw_begin();
+			pointer arrayEnd = raw_end();
+
+			if (eraseFirst < arrayBegin || eraseFirst > arrayEnd || eraseLast < arrayBegin || eraseLast > arrayEnd || eraseLast < eraseFirst) throw std::out_of_range("position out of range");
+			if (eraseFirst == eraseLast || eraseFirst == arrayEnd) return arrayEnd;
+
+			pointer destroyBegin = std::move(eraseLast, arrayEnd, eraseFirst);
+			std::destroy(destroyBegin, arrayEnd);
+			mSize = destroyBegin - arrayBegin;
+
+			return eraseFirst;
+		}
+		iterator remove(iterator pos)requires strong_movable<value_type> {
+			pointer removeElem = pos.base();
+			pointer arrayBegin = raw_begin();
+			pointer arrayEnd = raw_end();
+
+			if (removeElem < arrayBegin || removeElem > arrayEnd) throw std::out_of_range("position out of range");
+			if (removeElem == arrayEnd) return arrayEnd;
+
+			--arrayEnd;
+			*removeElem = std::move(*arrayEnd);
+			std::destroy_at(arrayEnd);
+			--mSize;
+			return removeElem;
+		}
+		template <typename UnaryPred>
+		iterator remove(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred, const_reference> {
+			pointer current = raw_begin();
+			pointer validEnd = raw_end();
+
+			while (current < validEnd) {
+				if (predicate(*current)) {
+					--validEnd;
+					if (current != validEnd)
+						*current = std::move(*validEnd);
+				}
+				else {
+					++current;
+				}
+			}
+
+			std::destroy(validEnd, raw_end());
+			mSize = validEnd - raw_begin();
+			return validEnd;
+		}
+		void swap(SmallSequence& rhs) requires strong_movable<value_type> {//inline storage can't be pointer swapped, elements walk over
+			SmallSequence temp(std::move(rhs));
+			rhs = std::move(*this);
+			*this = std::move(temp);
+		}
+		//#################################################
+
+		//CAPACITY
+		constexpr bool      isEmpty()const noexcept  { return mSize == 0; }
+		constexpr bool      isValid()const noexcept  { return true; }//there is always a buffer, kept for parity with Sequence
+		bool                isInline()const noexcept { return array == reinterpret_cast<const_pointer>(buffer); }
+		constexpr size_type size()const noexcept     { return mSize; }
+		constexpr size_type capacity()const noexcept { return cap; }
+		constexpr allocator_type get_allocator()const noexcept { return alloc; }
+
+		void resize_shrink(size_type count)noexcept {
+			if (count >= mSize) return;
+
+			std::destroy(raw_begin() + count, raw_end());
+			mSize = count;
+		}
+		void resize_grow(size_type count)requires std::default_initializable<value_type> && strong_movable<value_type> {
+			if (count <= mSize) return;
+
+			if (count > cap) {
+				tryReAllocate(count);//exact, like Sequence::resize_grow. geometric growth is for one element at a time
+			}
+
+			pointer startAt = raw_end();
+			pointer ifFailurePosition = startAt;
+			size_type amount = count - mSize;
+
+			try {
+				ifFailurePosition = std::uninitialized_value_construct_n(startAt, amount);
+				mSize = count;
+			}
+			catch (...) {
+				std::destroy(startAt, ifFailurePosition);
+				throw;
+			}
+		}
+		void reserve(size_type newCap) requires strong_movable<value_type> {
+			if (newCap > cap) {
+				tryReAllocate(newCap);
+			}
+		}
+		void shrinkToFit() requires strong_movable<value_type> {
+			if (isInline() || cap == mSize)
+				return;
+			if (mSize <= N) {//fits back inline, relocation of movable types can't throw
+				pointer heap = array;
+				size_type heapCap = cap;
+				relocateInto(inlineData());
+				memDealloc(heap, heapCap);
+				array = inlineData();
+				cap = N;
+				return;
+			}
+			tryReAllocate(mSize);
+		}
+		void clear() noexcept {
+			objDestroyAll();
+		}
+		//#################################################
+	private:
+		//members
+		SEQ_NO_UNIQUE_ADDRESS allocator_type alloc;
+		pointer array = inlineData();
+		size_type mSize = 0;
+		size_type cap = N;
+		alignas(T) std::byte buffer[N * sizeof(T)];
+	};
+
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator==(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator!=(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return !(lhs == rhs);
+	}
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator<(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator>(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return rhs < lhs;
+	}
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator<=(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return !(rhs < lhs);
+	}
+	template <typename T, std::size_t N, typename Allocator>
+	bool operator>=(const SmallSequence<T, N, Allocator>& lhs, const SmallSequence<T, N, Allocator>& rhs) {
+		return !(lhs < rhs);
+	}
+
+	template <typename T, std::size_t N, typename Allocator>
+	void swap(SmallSequence<T, N, Allocator>& lhs, SmallSequence<T, N, Allocator>& rhs) {
+		lhs.swap(rhs);
+	}
+}
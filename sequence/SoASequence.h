@@ -0,0 +1,333 @@
+#pragma once
+
+#include "Sequence.h"
+#include <cstddef>
+#include <new>
+#include <span>
+#include <tuple>
+
+namespace seq {
+	//structure of arrays: every field gets its own contiguous column, all columns share size/capacity and live in one
+	//allocation (each column starts on a cache line). loops that touch one field only pull that field through the cache.
+	//element access hands out tuples of references, column<I>() hands out a span for the vectorized loops
+	template <typename... Fields>
+	class SoASequence {
+	private:
+		static_assert(sizeof...(Fields) > 0, "SoASequence needs at least one field");
+		static_assert((std::is_object_v<Fields> && ...), "fields must be object types");
+		static_assert((!std::is_const_v<Fields> && ...), "fields cannot be const");
+		static_assert((std::is_nothrow_move_constructible_v<Fields> && ...), "fields must be nothrow move constructible, columns grow in lockstep and can't half fail");
+
+		template <bool Const> class BasicIterator;
+
+		static constexpr std::size_t column_count = sizeof...(Fields);
+		static constexpr std::size_t column_alignment = std::max({ std::size_t(64), alignof(Fields)... });
+		using indices = std::index_sequence_for<Fields...>;
+	public:
+		//type names
+		using type            = SoASequence<Fields...>;
+		using value_type      = std::tuple<Fields...>;
+		using reference       = std::tuple<Fields&...>;
+		using const_reference = std::tuple<const Fields&...>;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		template <std::size_t I>
+		using field_type      = std::tuple_element_t<I, value_type>;
+
+		using iterator        = BasicIterator<false>;
+		using const_iterator  = BasicIterator<true>;
+		//#################################################
+
+	private:
+		//the important shit
+		static constexpr size_type columnBytes(size_type bytes)noexcept {
+			return (bytes + column_alignment - 1) / column_alignment * column_alignment;
+		}
+		static constexpr size_type blockBytes(size_type count)noexcept {
+			return (columnBytes(count * sizeof(Fields)) + ...);
+		}
+		template <std::size_t... I>
+		static std::tuple<Fields*...> carve(std::byte* block, size_type count, std::index_sequence<I...>)noexcept {
+			std::tuple<Fields*...> result;
+			std::byte* at = block;
+			((std::get<I>(result) = reinterpret_cast<field_type<I>*>(at), at += columnBytes(count * sizeof(field_type<I>))), ...);
+			return result;
+		}
+		void tryReAllocate(size_type count) {//one block for every column, each column relocated into its slice
+			std::byte* newBlock = static_cast<std::byte*>(::operator new(blockBytes(count), std::align_val_t(column_alignment)));
+			std::tuple<Fields*...> newColumns = carve(newBlock, count, indices{});
+			relocateColumns(newColumns, indices{});
+			memFree();
+
+			block = newBlock;
+			columns = newColumns;
+			cap = count;
+		}
+		template <std::size_t... I>
+		void relocateColumns(std::tuple<Fields*...>& dest, std::index_sequence<I...>)noexcept {
+			(relocate(std::get<I>(columns), std::get<I>(dest)), ...);
+		}
+		template <typename F>
+		void relocate(F* from, F* to)noexcept {
+			if constexpr (is_trivially_relocatable_v<F>) {
+				if (mSize > 0)
+					std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), mSize * sizeof(F));
+			}
+			else {
+				std::uninitialized_move(from, from + mSize, to);
+				std::destroy(from, from + mSize);
+			}
+		}
+		template <std::size_t I, typename Arg, typename... Rest>
+		void constructRow(size_type row, Arg&& arg, Rest&&... rest) {//builds column I onward at row, unwinds the earlier columns on a throw
+			std::construct_at(std::get<I>(columns) + row, std::forward<Arg>(arg));
+			if constexpr (sizeof...(Rest) > 0) {
+				try {
+					constructRow<I + 1>(row, std::forward<Rest>(rest)...);
+				}
+				catch (...) {
+					std::destroy_at(std::get<I>(columns) + row);
+					throw;
+				}
+			}
+		}
+		//#################################################
+
+		//the convenience
+		void memFree()noexcept {
+			if (block) {
+				::operator delete(block, std::align_val_t(column_alignment));
+				block = nullptr;
+				columns = {};
+				cap = 0;
+			}
+		}
+		template <std::size_t... I>
+		void destroyRows(size_type first, size_type last, std::index_sequence<I...>)noexcept {
+			(std::destroy(std::get<I>(columns) + first, std::get<I>(columns) + last), ...);
+		}
+		template <std::size_t... I>
+		void moveRows(size_type from, size_type last, size_type to, std::index_sequence<I...>)noexcept {//std::move semantics per column
+			(std::move(std::get<I>(columns) + from, std::get<I>(columns) + last, std::get<I>(columns) + to), ...);
+		}
+		template <std::size_t... I>
+		reference row(size_type index, std::index_sequence<I...>)noexcept {
+			return reference(std::get<I>(columns)[index]...);
+		}
+		template <std::size_t... I>
+		const_reference row(size_type index, std::index_sequence<I...>)const noexcept {
+			return const_reference(std::get<I>(columns)[index]...);
+		}
+		void objDestroyAll()noexcept {
+			destroyRows(0, mSize, indices{});
+			mSize = 0;
+		}
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		SoASequence()noexcept = default;
+		SoASequence(const SoASequence& rhs) requires (std::copyable<Fields> && ...)
+			:SoASequence() {//delegated, so a throwing copy finds a constructed object whose destructor frees what was built
+			if (rhs.mSize == 0)
+				return;
+			reserve(rhs.mSize);
+			for (size_type i = 0; i < rhs.mSize; i++)
+				std::apply([this](const Fields&... values) { push_back(values...); }, rhs[i]);
+		}
+		SoASequence(SoASequence&& rhs)noexcept
+			:block(std::exchange(rhs.block, nullptr)), columns(std::exchange(rhs.columns, {})), mSize(std::exchange(rhs.mSize, 0)), cap(std::exchange(rhs.cap, 0)) {}
+		SoASequence& operator=(SoASequence rhs)noexcept {
+			rhs.swap(*this);
+			return *this;
+		}
+		~SoASequence()noexcept {
+			objDestroyAll();
+			memFree();
+		}
+		//#################################################
+
+		//ACCESS
+		reference operator[](size_type index)noexcept {
+			assert(index < mSize);
+			return row(index, indices{});
+		}
+		const_reference operator[](size_type index)const noexcept {
+			assert(index < mSize);
+			return row(index, indices{});
+		}
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return row(pos, indices{});
+		}
+		const_reference at(size_type pos)const {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return row(pos, indices{});
+		}
+		reference front()noexcept             { assert(mSize > 0); return row(0, indices{}); }
+		const_reference front()const noexcept { assert(mSize > 0); return row(0, indices{}); }
+		reference back()noexcept              { assert(mSize > 0); return row(mSize - 1, indices{}); }
+		const_reference back()const noexcept  { assert(mSize > 0); return row(mSize - 1, indices{}); }
+
+		template <std::size_t I>
+		field_type<I>& get(size_type index)noexcept {
+			assert(index < mSize);
+			return std::get<I>(columns)[index];
+		}
+		template <std::size_t I>
+		const field_type<I>& get(size_type index)const noexcept {
+			assert(index < mSize);
+			return std::get<I>(columns)[index];
+		}
+		template <std::size_t I>
+		std::span<field_type<I>> column()noexcept { return { std::get<I>(columns), mSize }; }
+		template <std::size_t I>
+		std::span<const field_type<I>> column()const noexcept { return { std::get<I>(columns), mSize }; }
+
+		iterator       begin()noexcept        { return { this, 0 }; }
+		iterator       end()noexcept          { return { this, difference_type(mSize) }; }
+		const_iterator begin()const noexcept  { return { this, 0 }; }
+		const_iterator end()const noexcept    { return { this, difference_type(mSize) }; }
+		const_iterator cbegin()const noexcept { return { this, 0 }; }
+		const_iterator cend()const noexcept   { return { this, difference_type(mSize) }; }
+		//#################################################
+
+		//MODIFICATION
+		template <typename... Args>
+		void push_back(Args&&... values) requires (sizeof...(Args) == column_count) && (std::constructible_from<Fields, Args&&> && ...) {
+			if (mSize == cap)
+				tryReAllocate(GrowGeometric{}.next(cap, mSize + 1));
+			constructRow<0>(mSize, std::forward<Args>(values)...);
+			++mSize;
+		}
+		void push_back(const value_type& values) requires (std::copyable<Fields> && ...) {
+			std::apply([this](const Fields&... fields) { push_back(fields...); }, values);
+		}
+		void pop_back()noexcept {
+			if (mSize > 0) {
+				destroyRows(mSize - 1, mSize, indices{});
+				--mSize;
+			}
+		}
+		iterator erase(iterator pos)requires (strong_movable<Fields> && ...) {
+			const size_type index = static_cast<size_type>(pos.index());
+			if (index > mSize) throw std::out_of_range("position out of range");
+			if (index == mSize) return end();
+
+			moveRows(index + 1, mSize, index, indices{});
+			destroyRows(mSize - 1, mSize, indices{});
+			--mSize;
+			return { this, difference_type(index) };
+		}
+		iterator erase(iterator first, iterator last)requires (strong_movable<Fields> && ...) {
+			const size_type eraseFirst = static_cast<size_type>(first.index());
+			const size_type eraseLast = static_cast<size_type>(last.index());
+			if (eraseFirst > mSize || eraseLast > mSize || eraseLast < eraseFirst) throw std::out_of_range("position out of range");
+			if (eraseFirst == eraseLast) return { this, difference_type(eraseFirst) };
+
+			moveRows(eraseLast, mSize, eraseFirst, indices{});
+			const size_type newSize = mSize - (eraseLast - eraseFirst);
+			destroyRows(newSize, mSize, indices{});
+			mSize = newSize;
+			return { this, difference_type(eraseFirst) };
+		}
+		iterator remove(iterator pos)requires (strong_movable<Fields> && ...) {//swap with last, O(1), order not kept
+			const size_type index = static_cast<size_type>(pos.index());
+			if (index > mSize) throw std::out_of_range("position out of range");
+			if (index == mSize) return end();
+
+			if (index != mSize - 1)
+				moveRows(mSize - 1, mSize, index, indices{});
+			destroyRows(mSize - 1, mSize, indices{});
+			--mSize;
+			return { this, difference_type(index) };
+		}
+		void swap(SoASequence& rhs)noexcept {
+			std::swap(block, rhs.block);
+			std::swap(columns, rhs.columns);
+			std::swap(mSize, rhs.mSize);
+			std::swap(cap, rhs.cap);
+		}
+		//#################################################
+
+		//CAPACITY
+		bool      isEmpty()const noexcept  { return mSize == 0; }
+		bool      isValid()const noexcept  { return block; }
+		size_type size()const noexcept     { return mSize; }
+		size_type capacity()const noexcept { return cap; }
+
+		void reserve(size_type newCap) {
+			if (newCap > cap)
+				tryReAllocate(newCap);
+		}
+		void shrinkToFit() {
+			if (cap > mSize) {
+				if (mSize == 0) {
+					memFree();
+					return;
+				}
+				tryReAllocate(mSize);
+			}
+		}
+		void clear()noexcept {
+			objDestroyAll();
+		}
+		//#################################################
+	private:
+		//members
+		std::byte* block = nullptr;
+		std::tuple<Fields*...> columns{};
+		size_type mSize = 0;
+		size_type cap = 0;
+	};
+
+	//proxy iterator: a (container, index) pair whose operator* is a tuple of references into the columns.
+	//same arithmetic and comparisons as Sequence's Iterator, index() plays the role of base()
+	template <typename... Fields>
+	template <bool Const>
+	class SoASequence<Fields...>::BasicIterator {
+		using owner_type = std::conditional_t<Const, const SoASequence, SoASequence>;
+	public:
+		using value_type = std::tuple<Fields...>;
+		using reference = std::conditional_t<Const, std::tuple<const Fields&...>, std::tuple<Fields&...>>;
+		using pointer = void;
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using self_type = BasicIterator;
+
+		constexpr reference operator*()const noexcept { return (*owner)[index()]; }
+		constexpr reference operator[](difference_type n)const noexcept { return (*owner)[pos + n]; }
+
+		constexpr self_type& operator++()noexcept { ++pos; return *this; }
+		constexpr self_type operator++(int)noexcept { self_type temp = *this; ++pos; return temp; }
+		constexpr self_type& operator--()noexcept { --pos; return *this; }
+		constexpr self_type operator--(int)noexcept { self_type temp = *this; --pos; return temp; }
+
+		constexpr self_type& operator+=(difference_type n)noexcept { pos += n; return *this; }
+		constexpr self_type& operator-=(difference_type n)noexcept { pos -= n; return *this; }
+		constexpr self_type operator+(difference_type n)const noexcept { return self_type(owner, pos + n); }
+		constexpr self_type operator-(difference_type n)const noexcept { return self_type(owner, pos - n); }
+		constexpr difference_type operator-(const self_type& rhs)const noexcept { return pos - rhs.pos; }
+		friend constexpr self_type operator+(difference_type n, const self_type& it)noexcept { return it + n; }
+
+		constexpr bool operator==(const self_type& rhs)const noexcept { return pos == rhs.pos; }
+		constexpr std::strong_ordering operator<=>(const self_type& rhs)const noexcept { return pos <=> rhs.pos; }
+
+		constexpr BasicIterator()noexcept = default;
+		constexpr BasicIterator(owner_type* owner, difference_type pos)noexcept :owner(owner), pos(pos) {}
+		template <bool OtherConst> requires (Const && !OtherConst)//a template, so it never stands in for the copy constructor
+		constexpr BasicIterator(const BasicIterator<OtherConst>& rhs)noexcept :owner(rhs.owner), pos(rhs.pos) {}
+		constexpr difference_type index()const noexcept { return pos; }
+	private:
+		friend class BasicIterator<true>;
+		owner_type* owner = nullptr;
+		difference_type pos = 0;
+	};
+
+	template <typename... Fields>
+	void swap(SoASequence<Fields...>& lhs, SoASequence<Fields...>& rhs)noexcept {
+		lhs.swap(rhs);
+	}
+}
@@ -1,44 +1,1072 @@
 #include "Sequence.h"
+#include "Arena.h"
+#include "MallocAllocator.h"
+#include "SmallSequence.h"
+#include "StaticSequence.h"
+#include "Parallel.h"
+#include "SoASequence.h"
+#include "ConcurrentSequence.h"
+#include "MappedSequence.h"
+#include "Serialize.h"
+#include "ChunkedSequence.h"
+#include "FlatMap.h"
+#include "Pipeline.h"
+#include "SharedSequence.h"
+#include "PageAllocator.h"
+#include "SlotMap.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 #include "Stopwatch.h"
-#include <vector>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#define _CRTDBG_MAP_ALLOC
+#include <stdlib.h>
+#include <crtdbg.h>
+#endif
+
+using namespace seq;
+using bench::Runner;
+
+//same bytes as int but opted out of relocation, forces the old element by element growth path
+struct MovedInt {
+	int value;
+	MovedInt(int v) :value(v) {}
+};
+template <>
+struct seq::is_trivially_relocatable<MovedInt> : std::false_type {};
+
+//a cache line of plain data
+struct Blob64 {
+	std::int64_t words[8];
+};
+
+struct Particle {
+	float x, y, z;
+	float vx, vy, vz;
+	float mass;
+	int flags;
+};
+
+//#################################################
+//element types and names for the core suite
+template <typename T> T makeValue(std::size_t i);
+template <> int makeValue<int>(std::size_t i)                 { return int(i); }
+template <> double makeValue<double>(std::size_t i)           { return double(i) * 0.5; }
+template <> std::string makeValue<std::string>(std::size_t i) { return std::string(24, char('a' + i % 26)); }//past any SSO
+template <> Blob64 makeValue<Blob64>(std::size_t i)           { return Blob64{ { std::int64_t(i) } }; }
+
+template <typename T> const char* elemName();
+template <> const char* elemName<int>()         { return "int"; }
+template <> const char* elemName<double>()      { return "double"; }
+template <> const char* elemName<float>()       { return "float"; }
+template <> const char* elemName<std::string>() { return "string"; }
+template <> const char* elemName<Blob64>()      { return "Blob64"; }
 
-#define _CRTDBG_MAP_ALLOC  
-#include <stdlib.h>  
-#include <crtdbg.h>  
-#include <conio.h>
+template <typename T> bool dropPredicate(const T& value);
+template <> bool dropPredicate<int>(const int& value)                 { return value % 3 == 0; }
+template <> bool dropPredicate<double>(const double& value)           { return int(value) % 3 == 0; }
+template <> bool dropPredicate<std::string>(const std::string& value) { return value[0] % 3 == 0; }
+template <> bool dropPredicate<Blob64>(const Blob64& value)           { return value.words[0] % 3 == 0; }
 
-auto f1() {
-	char a[] = { 's','e','c','r','e','t' };
+template <typename Container>
+Container filled(std::size_t n) {
+	Container c;
+	c.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		c.push_back(makeValue<typename Container::value_type>(i));
+	return c;
 }
-auto f2() {
-	char a[6];
-	std::cout << a;
+//the two containers spell "drop everything matching" differently
+template <typename T>
+void eraseMatching(Sequence<T>& c) { c.erase_if(dropPredicate<T>); }
+template <typename T>
+void eraseMatching(std::vector<T>& c) { std::erase_if(c, dropPredicate<T>); }
+
+//a fixture shared by several measurements is only worth building when the filter lets one of them through
+bool wantsAny(const Runner& runner, std::initializer_list<std::string> names, std::initializer_list<std::string> variants) {
+	for (const std::string& name : names) {
+		for (const std::string& variant : variants) {
+			if (runner.wants(name, variant))
+				return true;
+		}
+	}
+	return false;
 }
-using namespace seq;
-int main() {
+
+//#################################################
+//core suite: every basic operation, Sequence next to std::vector
+template <typename Container>
+void coreSuite(Runner& runner, const std::string& variant, std::size_t n) {
+	using T = typename Container::value_type;
+
+	runner.measure("push_back", variant, n, [] { return Container(); }, [n](Container& c) {
+		for (std::size_t i = 0; i < n; i++)
+			c.push_back(makeValue<T>(i));
+	});
+	runner.measure("emplace_back", variant, n, [] { return Container(); }, [n](Container& c) {
+		for (std::size_t i = 0; i < n; i++)
+			c.emplace_back(makeValue<T>(i));
+	});
+	runner.measure("reserve+push_back", variant, n, [] { return Container(); }, [n](Container& c) {
+		c.reserve(n);
+		for (std::size_t i = 0; i < n; i++)
+			c.push_back(makeValue<T>(i));
+	});
+	runner.measure("erase", variant, n, [n] { return filled<Container>(n); }, [n](Container& c) {
+		for (int i = 0; i < 100 && c.size() > 1; i++)
+			c.erase(c.begin() + c.size() / 2);
+		c.erase(c.begin() + c.size() / 4, c.begin() + c.size() / 2);
+	});
+	runner.measure("erase_if", variant, n, [n] { return filled<Container>(n); }, [](Container& c) {
+		eraseMatching(c);
+	});
+	const Container source = filled<Container>(n);
+	runner.measure("copy", variant, n, [] { return Container(); }, [&source](Container& c) {
+		c = source;
+	});
+	runner.measure("move", variant, n, [n] { return std::pair(filled<Container>(n), Container()); }, [](std::pair<Container, Container>& c) {
+		c.second = std::move(c.first);//both live in the state so neither destructor is timed
+	});
+}
+
+template <typename T>
+void coreSuites(Runner& runner) {
+	for (std::size_t n : { 1'000, 100'000 }) {
+		coreSuite<Sequence<T>>(runner, std::string("Sequence<") + elemName<T>() + ">", n);
+		coreSuite<std::vector<T>>(runner, std::string("std::vector<") + elemName<T>() + ">", n);
+	}
+	//Sequence only: unordered swap with last removal
+	runner.measure("remove(pred)", std::string("Sequence<") + elemName<T>() + ">", 100'000,
+		[] { return filled<Sequence<T>>(100'000); }, [](Sequence<T>& c) { c.remove(dropPredicate<T>); });
+}
+
+void benchReserveStep(Runner& runner) {//the original measurement: capacity grown by one, a thousand times
+	runner.measure("reserve(cap+1)", "Sequence<int>", 1000, [] { return Sequence<int>(); }, [](Sequence<int>& c) {
+		for (int i = 0; i < 1000; i++)
+			c.reserve(c.capacity() + 1);
+	});
+	runner.measure("reserve(cap+1)", "std::vector<int>", 1000, [] { return std::vector<int>(); }, [](std::vector<int>& c) {
+		for (int i = 0; i < 1000; i++)
+			c.reserve(c.capacity() + 1);
+	});
+}
+
+//#################################################
+//feature suites
+void benchArena(Runner& runner) {//build and discard short lived Sequences, heap vs arena
+	constexpr int frames = 1000;
+	constexpr int elems = 1000;
+	runner.measure("build+discard", "Sequence<int>", frames * elems, [] {
+		for (int f = 0; f < frames; f++) {
+			Sequence<int> frame;
+			for (int i = 0; i < elems; i++)
+				frame.push_back(i);
+			bench::doNotOptimize(frame);
+		}
+	});
+	Arena arena(1 << 20);
+	runner.measure("build+discard", "Sequence<int, ArenaAllocator>", frames * elems, [&arena] {
+		for (int f = 0; f < frames; f++) {
+			{
+				Sequence<int, ArenaAllocator<int>> frame{ ArenaAllocator<int>(arena) };
+				for (int i = 0; i < elems; i++)
+					frame.push_back(i);
+				bench::doNotOptimize(frame);
+			}
+			arena.reset();
+		}
+	});
+	runner.measure("build+discard", "pmr::Sequence<int> on Arena", frames * elems, [&arena] {
+		for (int f = 0; f < frames; f++) {
+			{
+				pmr::Sequence<int> frame{ std::pmr::polymorphic_allocator<int>(&arena) };
+				for (int i = 0; i < elems; i++)
+					frame.push_back(i);
+				bench::doNotOptimize(frame);
+			}
+			arena.reset();
+		}
+	});
+}
+
+void benchRelocate(Runner& runner) {//push_back growth: element wise move vs memcpy vs realloc
+	constexpr std::size_t elems = 10'000'000;
+	runner.measure("push_back growth", "Sequence<MovedInt> (move)", elems, [] { return Sequence<MovedInt>(); }, [](Sequence<MovedInt>& c) {
+		for (std::size_t i = 0; i < elems; i++)
+			c.push_back(int(i));
+	});
+	runner.measure("push_back growth", "Sequence<int> (memcpy)", elems, [] { return Sequence<int>(); }, [](Sequence<int>& c) {
+		for (std::size_t i = 0; i < elems; i++)
+			c.push_back(int(i));
+	});
+	using Realloc = Sequence<int, MallocAllocator<int>>;
+	runner.measure("push_back growth", "Sequence<int, Malloc> (realloc)", elems, [] { return Realloc(); }, [](Realloc& c) {
+		for (std::size_t i = 0; i < elems; i++)
+			c.push_back(int(i));
+	});
+}
+
+void benchSmall(Runner& runner) {//lots of tiny containers, the common case SmallSequence is for
+	constexpr int containers = 100'000;
+	constexpr int elems = 12;
+	runner.measure("12 elems x1e5", "Sequence<int>", containers, [] {
+		for (int c = 0; c < containers; c++) {
+			Sequence<int> test;
+			for (int i = 0; i < elems; i++)
+				test.push_back(i);
+			bench::doNotOptimize(test);
+		}
+	});
+	runner.measure("12 elems x1e5", "SmallSequence<int, 16>", containers, [] {
+		for (int c = 0; c < containers; c++) {
+			SmallSequence<int, 16> test;
+			for (int i = 0; i < elems; i++)
+				test.push_back(i);
+			bench::doNotOptimize(test);
+		}
+	});
+	runner.measure("12 elems x1e5", "StaticSequence<int, 16>", containers, [] {
+		for (int c = 0; c < containers; c++) {
+			StaticSequence<int, 16> test;
+			for (int i = 0; i < elems; i++)
+				test.push_back(i);
+			bench::doNotOptimize(test);
+		}
+	});
+}
+
+//crc32 lookup table, the same code fills a Sequence at run time or a StaticSequence at compile time
+template <typename Table>
+constexpr Table crcTable() {
+	Table table;
+	for (std::uint32_t i = 0; i < 256; i++) {
+		std::uint32_t crc = i;
+		for (int bit = 0; bit < 8; bit++)
+			crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+		table.push_back(crc);
+	}
+	return table;
+}
+constexpr auto compiledCrcTable = crcTable<StaticSequence<std::uint32_t, 256>>();
+#ifndef SEQ_STATS
+//a Sequence can't outlive constant evaluation, but it can be used there. SEQ_STATS builds carry a non literal instrument
+static_assert(std::ranges::equal(crcTable<Sequence<std::uint32_t>>(), compiledCrcTable));
+#endif
+template <typename Table>
+std::uint32_t crc32(const Table& table, const std::uint8_t* bytes, std::size_t count) {
+	std::uint32_t crc = ~0u;
+	for (std::size_t i = 0; i < count; i++)
+		crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+void benchStatic(Runner& runner) {//a short crc per call, the table built at startup of every call vs baked in by the compiler
+	constexpr std::size_t calls = 10'000;
+	constexpr std::size_t bytes = 64;
+	std::uint8_t message[bytes];
+	std::iota(message, message + bytes, std::uint8_t(0));
+	runner.measure("crc32 64B x1e4", "table built at run time", calls, [&] {
+		std::uint32_t total = 0;
+		for (std::size_t c = 0; c < calls; c++) {
+			const Sequence<std::uint32_t> table = crcTable<Sequence<std::uint32_t>>();
+			total += crc32(table, message, bytes);
+		}
+		bench::doNotOptimize(total);
+	});
+	runner.measure("crc32 64B x1e4", "constexpr StaticSequence", calls, [&] {
+		std::uint32_t total = 0;
+		for (std::size_t c = 0; c < calls; c++)
+			total += crc32(compiledCrcTable, message, bytes);
+		bench::doNotOptimize(total);
+	});
+}
+
+template <typename Growth>
+void growthCase(Runner& runner, const char* policy, bool pushLoop) {
+	constexpr std::size_t elems = 1'000'000;
+	using Tracked = Sequence<int, MallocAllocator<int>, seq::Tracked<Growth>>;
+	auto& result = pushLoop
+		? runner.measure("push_back growth", policy, elems, [] { return Tracked(); }, [](Tracked& c) {
+			for (std::size_t i = 0; i < elems; i++)
+				c.push_back(int(i));
+		})
+		: runner.measure("resize_grow", policy, elems, [] { return Tracked(); }, [](Tracked& c) {
+			c.resize_grow(elems);
+		});
+	//the timed runs' containers are gone by now, rerun once on the side for the counters
+	Tracked probe;
+	if (pushLoop) {
+		for (std::size_t i = 0; i < elems; i++)
+			probe.push_back(int(i));
+	}
+	else {
+		probe.resize_grow(elems);
+	}
+	result.counter("reallocations", double(probe.growth_policy().reallocations))
+		.counter("bytes_wasted", double(probe.growth_policy().bytesWasted))
+		.counter("peak_wasted", double(probe.growth_policy().peakWasted));
+}
+void benchGrowth(Runner& runner) {
+	growthCase<GrowGeometric>(runner, "GrowGeometric", true);
+	growthCase<GrowDouble>(runner, "GrowDouble", true);
+	growthCase<GrowSizeClass>(runner, "GrowSizeClass", true);
+	growthCase<GrowGeometric>(runner, "GrowGeometric", false);
+	growthCase<GrowExact>(runner, "GrowExact", false);//exact on a push_back loop is quadratic by design
+}
+
+void benchBulk(Runner& runner) {//one logical batch: element by element vs one append_range
+	constexpr std::size_t elems = 10'000'000;
+	if (!wantsAny(runner, { "append 1e7" }, { "push_back loop", "append_range", "append_uninitialized+memcpy" }))
+		return;
+	const std::vector<int> source(elems, 7);
+	runner.measure("append 1e7", "push_back loop", elems, [] { return Sequence<int>(); }, [&source](Sequence<int>& c) {
+		for (int v : source)
+			c.push_back(v);
+	});
+	runner.measure("append 1e7", "append_range", elems, [] { return Sequence<int>(); }, [&source](Sequence<int>& c) {
+		c.append_range(source);
+	});
+	runner.measure("append 1e7", "append_uninitialized+memcpy", elems, [] { return Sequence<int>(); }, [&source](Sequence<int>& c) {
+		int* out = c.append_uninitialized(elems);
+		std::memcpy(out, source.data(), elems * sizeof(int));
+	});
+}
+
+void benchEraseIf(Runner& runner) {//scattered deletes on random data, where a branchy loop mispredicts
+	constexpr std::size_t elems = 10'000'000;
+	if (!wantsAny(runner, { "scattered erase" }, { "Sequence remove(pred)", "Sequence erase_if", "std::erase_if vector" }))
+		return;
+	auto pred = [](int v) { return v % 3 == 0; };
+	Sequence<int> source;
+	unsigned rng = 12345;
+	for (std::size_t i = 0; i < elems; i++) {
+		rng = rng * 1664525u + 1013904223u;
+		source.push_back(int(rng >> 8));
+	}
+	const std::vector<int> vsource(source.begin(), source.end());
+	runner.measure("scattered erase", "Sequence remove(pred)", elems, [&source] { return source; }, [&pred](Sequence<int>& c) { c.remove(pred); });
+	runner.measure("scattered erase", "Sequence erase_if", elems, [&source] { return source; }, [&pred](Sequence<int>& c) { c.erase_if(pred); });
+	runner.measure("scattered erase", "std::erase_if vector", elems, [&vsource] { return vsource; }, [&pred](std::vector<int>& c) { std::erase_if(c, pred); });
+}
+
+void benchParallel(Runner& runner) {//thread scaling, 1 thread is the serial fallback
+	constexpr std::size_t elems = 4'000'000;
+	const std::initializer_list<std::string> names = { "parallel reduce", "parallel transform", "parallel sort" };
+	if (!wantsAny(runner, names, { "1 threads", "2 threads", "4 threads", "8 threads", "16 threads" }))
+		return;
+	Sequence<float> source;
+	unsigned rng = 777;
+	for (std::size_t i = 0; i < elems; i++) {
+		rng = rng * 1664525u + 1013904223u;
+		source.push_back(float(rng >> 8));
+	}
+	for (std::size_t threads : { 1, 2, 4, 8, 16 }) {
+		const std::string variant = std::to_string(threads) + " threads";
+		if (!wantsAny(runner, names, { variant }))
+			continue;
+		ThreadPool pool(threads);
+		parallel::Options options;
+		options.pool = &pool;
+
+		runner.measure("parallel reduce", variant, elems, [&] {
+			bench::doNotOptimize(parallel::reduce(source, 0.0, std::plus<>{}, options));
+		});
+		runner.measure("parallel transform", variant, elems, [&] { return Sequence<float>(elems); }, [&](Sequence<float>& out) {
+			parallel::transform(source, out.begin(), [](float v) { return v * 0.5f + 1.0f; }, options);
+		});
+		runner.measure("parallel sort", variant, elems, [&] { return source; }, [&](Sequence<float>& data) {
+			parallel::sort(data, std::less<>{}, options);
+		});
+	}
+}
+
+void benchSoA(Runner& runner) {//one hot field out of eight: array of structs vs structure of arrays
+	constexpr std::size_t elems = 4'000'000;
+	if (!wantsAny(runner, { "field sum", "field filter" }, { "AoS Sequence<Particle>", "SoASequence" }))
+		return;
+	Sequence<Particle> aos;
+	SoASequence<float, float, float, float, float, float, float, int> soa;
+	aos.reserve(elems);
+	soa.reserve(elems);
+	for (std::size_t i = 0; i < elems; i++) {
+		const float v = float(i % 1000);
+		aos.push_back(Particle{ v, v, v, v, v, v, v, int(i) });
+		soa.push_back(v, v, v, v, v, v, v, int(i));
+	}
+	runner.measure("field sum", "AoS Sequence<Particle>", elems, [&aos] {
+		float sum = 0.0f;
+		for (const Particle& p : aos)
+			sum += p.mass;
+		bench::doNotOptimize(sum);
+	});
+	runner.measure("field sum", "SoASequence", elems, [&soa] {
+		float sum = 0.0f;
+		for (float mass : soa.column<6>())
+			sum += mass;
+		bench::doNotOptimize(sum);
+	});
+	runner.measure("field filter", "AoS Sequence<Particle>", elems, [] { return Sequence<int>(); }, [&aos](Sequence<int>& hits) {
+		for (const Particle& p : aos)
+			if (p.mass > 900.0f)
+				hits.push_back(p.flags);
+	});
+	runner.measure("field filter", "SoASequence", elems, [] { return Sequence<int>(); }, [&soa](Sequence<int>& hits) {
+		auto mass = soa.column<6>();
+		auto flags = soa.column<7>();
+		for (std::size_t i = 0; i < mass.size(); i++)
+			if (mass[i] > 900.0f)
+				hits.push_back(flags[i]);
+	});
+}
+
+void benchConcurrent(Runner& runner) {//many producers appending at once: segmented lock free vs one mutex around a Sequence
+	constexpr int perThread = 250'000;
+	for (int threads : { 1, 2, 4, 8 }) {
+		const std::string producers = std::to_string(threads) + " producers";
+		runner.measure("concurrent append", producers + ", mutex Sequence", std::size_t(threads) * perThread, [threads] {
+			Sequence<int> shared;
+			std::mutex lock;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; t++) {
+				workers.emplace_back([&] {
+					for (int i = 0; i < perThread; i++) {
+						std::lock_guard<std::mutex> guard(lock);
+						shared.push_back(i);
+					}
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+		});
+		runner.measure("concurrent append", producers + ", ConcurrentSequence", std::size_t(threads) * perThread, [threads] {
+			ConcurrentSequence<int> shared;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; t++) {
+				workers.emplace_back([&] {
+					for (int i = 0; i < perThread; i++)
+						shared.push_back(i);
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+		});
+	}
+}
+
+void benchMapped(Runner& runner) {//startup of a 256MB record file: read and push vs one bulk read vs mapping it. warm page cache
+	constexpr std::size_t records = 4'000'000;
+	const std::string path = (std::filesystem::temp_directory_path() / "seq_bench_mapped.bin").string();
+	bool written = false;
+	auto writeOnce = [&] {
+		if (written)
+			return;
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		for (std::size_t i = 0; i < records; i++) {
+			const Blob64 record = makeValue<Blob64>(i);
+			out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+		}
+		written = true;
+	};
+
+	auto measureLoad = [&](const std::string& variant, auto load) {
+		if (!runner.wants("mapped open+scan", variant))
+			return;
+		writeOnce();
+		auto scan = [](const auto& loaded) {
+			std::int64_t sum = 0;
+			for (const Blob64& record : loaded)
+				sum += record.words[0];
+			bench::doNotOptimize(sum);
+		};
+		auto& result = runner.measure("mapped open+scan", variant, records, [&] { scan(load()); });
+		//one more load on the side, the resident set is read again while it is still alive
+		const std::size_t before = bench::residentBytes();
+		{
+			auto loaded = load();
+			scan(loaded);
+			const std::size_t after = bench::residentBytes();
+			result.counter("rss_growth_bytes", double(after > before ? after - before : 0));
+		}
+	};
+
+	measureLoad("ifstream + push_back", [&path] {
+		Sequence<Blob64> loaded;
+		std::ifstream in(path, std::ios::binary);
+		Blob64 record;
+		while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+			loaded.push_back(record);
+		return loaded;
+	});
+	measureLoad("ifstream bulk read", [&path] {
+		Sequence<Blob64> loaded;
+		std::ifstream in(path, std::ios::binary);
+		loaded.resize_for_overwrite(std::filesystem::file_size(path) / sizeof(Blob64));
+		in.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(Blob64));
+		return loaded;
+	});
+	measureLoad("MappedSequence readOnly", [&path] {//rss still grows as pages are touched, but they are clean file pages the kernel can drop
+		MappedSequence<const Blob64> loaded(path);
+		loaded.adviseSequential();
+		return loaded;
+	});
+	if (written)
+		std::filesystem::remove(path);
+}
+
+void withThroughput(bench::Result& result, double bytes) {//bytes per ns is GB/s
+	if (result.stats.median > 0.0)
+		result.counter("GB/s", bytes / result.stats.median);
+}
+void benchSerialize(Runner& runner) {//binary format vs the obvious per element iostream loop, files in the temp dir, warm page cache
+	const auto dir = std::filesystem::temp_directory_path();
+	const std::string rawPath = (dir / "seq_bench_raw.bin").string();
+	const std::string naivePath = (dir / "seq_bench_naive.bin").string();
+
+	constexpr std::size_t doubles = 16'000'000;
+	const double rawBytes = double(doubles * sizeof(double));
+	const std::string saveNumbers = "save 128MB", loadNumbers = "load 128MB";
+	const std::string ioLoad = "io::load (read into tail)", naiveLoad = "ifstream read per element + push_back";
+	if (wantsAny(runner, { saveNumbers }, { "io::save (writev)", "ofstream write per element" }) || wantsAny(runner, { loadNumbers }, { ioLoad, naiveLoad })) {
+		Sequence<double> numbers;
+		numbers.resize_grow(doubles);
+		for (std::size_t i = 0; i < doubles; i++)
+			numbers[i] = double(i) * 0.25;
+
+		withThroughput(runner.measure(saveNumbers, "io::save (writev)", doubles, [&] { io::save(rawPath, numbers); }), rawBytes);
+		withThroughput(runner.measure(saveNumbers, "ofstream write per element", doubles, [&] {
+			std::ofstream out(naivePath, std::ios::binary | std::ios::trunc);
+			for (double v : numbers)
+				out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+		}), rawBytes);
+		if (runner.wants(loadNumbers, ioLoad)) {
+			io::save(rawPath, numbers);
+			withThroughput(runner.measure(loadNumbers, ioLoad, doubles, [] { return Sequence<double>(); }, [&](Sequence<double>& into) {
+				io::load(rawPath, into);
+			}), rawBytes);
+		}
+		if (runner.wants(loadNumbers, naiveLoad)) {
+			{
+				std::ofstream out(naivePath, std::ios::binary | std::ios::trunc);
+				out.write(reinterpret_cast<const char*>(numbers.data()), std::streamsize(rawBytes));
+			}
+			withThroughput(runner.measure(loadNumbers, naiveLoad, doubles, [] { return Sequence<double>(); }, [&](Sequence<double>& into) {
+				std::ifstream in(naivePath, std::ios::binary);
+				double v;
+				while (in.read(reinterpret_cast<char*>(&v), sizeof(v)))
+					into.push_back(v);
+			}), rawBytes);
+		}
+	}
+
+	constexpr std::size_t strings = 1'000'000;
+	const double textBytes = double(strings * 24);
+	const std::string saveWords = "save 1e6 strings", loadWords = "load 1e6 strings";
+	const std::string chunkedLoad = "io::load (chunked)", naiveSave = "ofstream << per element", getlineLoad = "getline per element + push_back";
+	if (wantsAny(runner, { saveWords }, { "io::save (chunked)", naiveSave }) || wantsAny(runner, { loadWords }, { chunkedLoad, getlineLoad })) {
+		Sequence<std::string> words;
+		for (std::size_t i = 0; i < strings; i++)
+			words.push_back(makeValue<std::string>(i));
+		withThroughput(runner.measure(saveWords, "io::save (chunked)", strings, [&] { io::save(rawPath, words); }), textBytes);
+		auto saveNaive = [&] {
+			std::ofstream out(naivePath, std::ios::trunc);
+			for (const std::string& word : words)
+				out << word << '\n';
+		};
+		withThroughput(runner.measure(saveWords, naiveSave, strings, saveNaive), textBytes);
+		if (runner.wants(loadWords, chunkedLoad)) {
+			io::save(rawPath, words);
+			withThroughput(runner.measure(loadWords, chunkedLoad, strings, [] { return Sequence<std::string>(); }, [&](Sequence<std::string>& into) {
+				io::load(rawPath, into);
+			}), textBytes);
+		}
+		if (runner.wants(loadWords, getlineLoad)) {
+			if (!runner.wants(saveWords, naiveSave))
+				saveNaive();
+			withThroughput(runner.measure(loadWords, getlineLoad, strings, [] { return Sequence<std::string>(); }, [&](Sequence<std::string>& into) {
+				std::ifstream in(naivePath);
+				std::string word;
+				while (std::getline(in, word))
+					into.push_back(word);
+			}), textBytes);
+		}
+	}
+
+	std::filesystem::remove(rawPath);//false, not a throw, for a file the filter never had written
+	std::filesystem::remove(naivePath);
+}
+
+template <typename T> void popFront(Sequence<T>& c)        { c.erase(c.begin()); }
+template <typename T> void popFront(std::deque<T>& c)      { c.pop_front(); }
+template <typename T> void popFront(ChunkedSequence<T>& c) { c.pop_front(); }
+
+template <typename Container>
+void fifoCase(Runner& runner, const std::string& variant, std::size_t depth, std::size_t ops) {
+	runner.measure("fifo depth " + std::to_string(depth), variant, ops, [depth] {
+		Container queue;
+		for (std::size_t i = 0; i < depth; i++)
+			queue.push_back(int(i));
+		return queue;
+	}, [ops](Container& queue) {
+		for (std::size_t i = 0; i < ops; i++) {
+			queue.push_back(int(i));
+			popFront(queue);
+		}
+		bench::doNotOptimize(queue.front());
+	});
+}
+
+void benchChunked(Runner& runner) {//steady state queue, push at the back and pop at the front. erase(begin()) is O(depth) per pop
+	constexpr std::size_t ops = 100'000;
+	for (std::size_t depth : { 64, 8192 }) {
+		fifoCase<Sequence<int>>(runner, "Sequence erase(begin())", depth, ops);
+		fifoCase<std::deque<int>>(runner, "std::deque", depth, ops);
+		fifoCase<ChunkedSequence<int>>(runner, "ChunkedSequence", depth, ops);
+	}
+}
+
+template <typename Body>
+void perLevel(Runner& runner, const std::string& name, std::size_t n, Body body) {//the same call once per instruction set the cpu has
+	for (simd::Level level : { simd::Level::sse2, simd::Level::avx2, simd::Level::avx512 }) {
+		if (level > simd::detectedLevel())
+			break;
+		simd::setLevel(level);
+		runner.measure(name, std::string("simd ") + simd::levelName(level), n, body);
+	}
+	simd::setLevel(simd::detectedLevel());
+}
+
+template <typename T>
+void simdCases(Runner& runner, std::size_t n) {//whole range scans: the needle is never there, so find reads every element too
+	std::mt19937 rng(7);
+	Sequence<T> values;
+	values.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		values.push_back(T(rng() % 1000));
+	const Sequence<T> same = values;
+	const T* first = values.data();
+	const T* last = first + values.size();
+	const std::string suffix = std::string(" ") + elemName<T>() + " 1e6";
+
+	runner.measure("find" + suffix, "std::find", n, [&] { bench::doNotOptimize(std::find(first, last, T(-1))); });
+	perLevel(runner, "find" + suffix, n, [&] { bench::doNotOptimize(simd::find(first, last, T(-1))); });
+	runner.measure("count" + suffix, "std::count", n, [&] { bench::doNotOptimize(std::count(first, last, T(7))); });
+	perLevel(runner, "count" + suffix, n, [&] { bench::doNotOptimize(simd::count(first, last, T(7))); });
+	runner.measure("min_max" + suffix, "std::minmax_element", n, [&] { bench::doNotOptimize(std::minmax_element(first, last)); });
+	perLevel(runner, "min_max" + suffix, n, [&] { bench::doNotOptimize(simd::min_max(first, last)); });
+	runner.measure("sum" + suffix, "std::accumulate", n, [&] { bench::doNotOptimize(std::accumulate(first, last, simd::sum_t<T>(0))); });
+	perLevel(runner, "sum" + suffix, n, [&] { bench::doNotOptimize(simd::sum(first, last)); });
+	runner.measure("equal" + suffix, "std::equal", n, [&] { bench::doNotOptimize(std::equal(first, last, same.data())); });
+	if constexpr (std::is_integral_v<T>)
+		runner.measure("equal" + suffix, "operator== (memcmp)", n, [&] { bench::doNotOptimize(values == same); });
+	else
+		perLevel(runner, "equal" + suffix, n, [&] { bench::doNotOptimize(values == same); });
+}
+
+void benchSimd(Runner& runner) {
+	simdCases<int>(runner, 1'000'000);
+	simdCases<float>(runner, 1'000'000);
+}
+
+template <typename Map>
+void lookupCase(Runner& runner, const std::string& name, const std::string& variant, const Map& map, const Sequence<int>& queries) {
+	runner.measure(name, variant, queries.size(), [&] {
+		std::size_t hits = 0;
+		for (int key : queries)
+			hits += map.find(key) != map.end();
+		bench::doNotOptimize(hits);
+	});
+}
+
+void benchFlat(Runner& runner) {//lookup heavy: build once, then a million finds, about half of them hits
+	constexpr std::size_t lookups = 1'000'000;
+	for (std::size_t n : { 10'000, 1'000'000 }) {
+		const std::string size = n == 10'000 ? "1e4" : "1e6";
+		const std::string build = "map build " + size;
+		const std::string find = "map find " + size + " keys";
+		if (!wantsAny(runner, { build }, { "std::map insert", "std::unordered_map insert", "FlatMap bulk" })
+			&& !wantsAny(runner, { find }, { "std::map", "std::unordered_map", "FlatMap binary", "FlatMap eytzinger" }))
+			continue;
+
+		std::mt19937 rng(11);
+		Sequence<int> keys, values, queries;
+		for (std::size_t i = 0; i < n; i++) {
+			keys.push_back(int(rng() % (4 * n)));
+			values.push_back(int(i));
+		}
+		for (std::size_t i = 0; i < lookups; i++)
+			queries.push_back(i % 2 ? keys[rng() % n] : int(rng() % (4 * n)));
+
+		runner.measure(build, "std::map insert", n, [&] {
+			std::map<int, int> map;
+			for (std::size_t i = 0; i < n; i++)
+				map.emplace(keys[i], values[i]);
+			bench::doNotOptimize(map);
+		});
+		runner.measure(build, "std::unordered_map insert", n, [&] {
+			std::unordered_map<int, int> map;
+			for (std::size_t i = 0; i < n; i++)
+				map.emplace(keys[i], values[i]);
+			bench::doNotOptimize(map);
+		});
+		runner.measure(build, "FlatMap bulk", n, [&] {
+			FlatMap<int, int> map(keys, values);
+			bench::doNotOptimize(map);
+		});
+
+		if (runner.wants(find, "std::map")) {
+			std::map<int, int> tree;
+			for (std::size_t i = 0; i < n; i++)
+				tree.emplace(keys[i], values[i]);
+			lookupCase(runner, find, "std::map", tree, queries);
+		}
+		if (runner.wants(find, "std::unordered_map")) {
+			std::unordered_map<int, int> hashed;
+			for (std::size_t i = 0; i < n; i++)
+				hashed.emplace(keys[i], values[i]);
+			lookupCase(runner, find, "std::unordered_map", hashed, queries);
+		}
+		if (runner.wants(find, "FlatMap binary"))
+			lookupCase(runner, find, "FlatMap binary", FlatMap<int, int>(keys, values), queries);
+		if (runner.wants(find, "FlatMap eytzinger"))
+			lookupCase(runner, find, "FlatMap eytzinger", FlatMap<int, int, std::less<int>, EytzingerSearch>(keys, values), queries);
+	}
+}
+
+//what entity storage looks like without SlotMap: swap with last removal plus a side table from stable id to position
+struct IndexedSequence {
+	Sequence<float> values;
+	Sequence<std::uint64_t> ids;//ids[i] owns values[i]
+	std::unordered_map<std::uint64_t, std::size_t> where;
+	std::uint64_t nextId = 0;
+
+	std::uint64_t insert(float value) {
+		values.push_back(value);
+		ids.push_back(nextId);
+		where.emplace(nextId, values.size() - 1);
+		return nextId++;
+	}
+	void erase(std::uint64_t id) {
+		const auto found = where.find(id);
+		const std::size_t at = found->second;
+		where.erase(found);
+		if (at != values.size() - 1)
+			where[ids.back()] = at;
+		values.remove(values.begin() + at);
+		ids.remove(ids.begin() + at);
+	}
+	float& operator[](std::uint64_t id) { return values[where.find(id)->second]; }
+};
+template <typename Container, typename Handle>
+void churnCase(Runner& runner, const std::string& variant, std::size_t erases, std::size_t lookups) {
+	constexpr std::size_t live = 100'000;
+	constexpr std::size_t rounds = 100;
+	struct State {
+		Container entities;
+		Sequence<Handle> handles;
+		std::mt19937 rng{ 5 };
+	};
+	runner.measure("churn " + std::to_string(erases) + "/" + std::to_string(lookups), variant, rounds * live, [] {
+		State state;
+		for (std::size_t i = 0; i < live; i++)
+			state.handles.push_back(state.entities.insert(float(i)));
+		return state;
+	}, [=](State& state) {
+		for (std::size_t round = 0; round < rounds; round++) {
+			for (std::size_t i = 0; i < erases; i++) {//replace random entities, the handle list itself is order free
+				const std::size_t pick = state.rng() % state.handles.size();
+				state.entities.erase(state.handles[pick]);
+				state.handles[pick] = state.entities.insert(float(round));
+			}
+			for (std::size_t i = 0; i < lookups; i++)
+				state.entities[state.handles[state.rng() % live]] += 1.0f;
+			float total = 0;//the per frame pass over everything
+			if constexpr (std::is_same_v<Container, IndexedSequence>)
+				total = state.entities.values.sum();
+			else
+				total = state.entities.view().sum();
+			bench::doNotOptimize(total);
+		}
+	});
+}
+void benchSlotMap(Runner& runner) {//100k live entities, per round: replace some, touch some through their handles, scan all. named replaced/touched
+	for (auto [erases, lookups] : { std::pair<std::size_t, std::size_t>{ 100, 1'000 }, { 10'000, 1'000 }, { 100, 50'000 } }) {
+		churnCase<IndexedSequence, std::uint64_t>(runner, "Sequence + unordered_map", erases, lookups);
+		churnCase<SlotMap<float>, SlotHandle>(runner, "SlotMap", erases, lookups);
+	}
+}
+
+void benchViews(Runner& runner) {//handing a batch to the next stage: copy it out vs pass a window vs give the whole block away
+	constexpr std::size_t n = 1'000'000;
+	Sequence<int> batch;
+	for (std::size_t i = 0; i < n; i++)
+		batch.push_back(int(i));
+	auto consume = [](SequenceView<const int> part) { return part.sum(); };
+
+	runner.measure("hand off quarter 1e6", "copy into Sequence", n / 4, [&] {
+		Sequence<int> part;
+		part.append_range(batch.slice(n / 4, n / 4));
+		bench::doNotOptimize(consume(part));
+	});
+	runner.measure("hand off quarter 1e6", "slice view", n / 4, [&] {
+		bench::doNotOptimize(consume(batch.slice(n / 4, n / 4)));
+	});
+
+	runner.measure("hand off whole 1e6", "copy constructor", n, [&] {
+		Sequence<int> next(batch);
+		bench::doNotOptimize(next);
+	});
+	runner.measure("hand off whole 1e6", "release + adopt", n, [&] {
+		Sequence<int> next(adopt_buffer, batch.release());
+		bench::doNotOptimize(next);
+		batch = next.take();//back for the next repetition
+	});
+}
+
+void benchPipeline(Runner& runner) {//filter -> transform -> filter -> collect: a Sequence per step vs std::views vs the fused pipe
+	constexpr std::size_t n = 1'000'000;
+	std::mt19937 rng(5);
+	Sequence<int> input;
+	for (std::size_t i = 0; i < n; i++)
+		input.push_back(int(rng() % 1000));
+	auto keep = [](int x) { return x % 3 != 0; };
+	auto scale = [](int x) { return x * 7 + 1; };
+	auto small = [](int x) { return x < 4000; };
+
+	runner.measure("pipeline 3 stages 1e6", "eager Sequences", n, [&] {
+		Sequence<int> kept;
+		for (int x : input)
+			if (keep(x))
+				kept.push_back(x);
+		Sequence<int> scaled;
+		scaled.reserve(kept.size());
+		for (int x : kept)
+			scaled.push_back(scale(x));
+		Sequence<int> out;
+		for (int x : scaled)
+			if (small(x))
+				out.push_back(x);
+		bench::doNotOptimize(out);
+	});
+	runner.measure("pipeline 3 stages 1e6", "std::views", n, [&] {
+		Sequence<int> out;
+		out.append_range(input | std::views::filter(keep) | std::views::transform(scale) | std::views::filter(small));
+		bench::doNotOptimize(out);
+	});
+	runner.measure("pipeline 3 stages 1e6", "pipe fused", n, [&] {
+		auto out = input | pipe::filter(keep) | pipe::transform(scale) | pipe::filter(small) | pipe::collect();
+		bench::doNotOptimize(out);
+	});
+
+	runner.measure("pipeline 2 maps 1e6", "eager Sequences", n, [&] {
+		Sequence<int> scaled;
+		for (int x : input)
+			scaled.push_back(scale(x));
+		Sequence<int> out;
+		for (int x : scaled)
+			out.push_back(x ^ 0x55);
+		bench::doNotOptimize(out);
+	});
+	runner.measure("pipeline 2 maps 1e6", "pipe fused", n, [&] {
+		auto out = input | pipe::transform(scale) | pipe::transform([](int x) { return x ^ 0x55; }) | pipe::collect();
+		bench::doNotOptimize(out);
+	});
+}
+
+void benchShared(Runner& runner) {//one snapshot handed to 16 readers that each sum it: deep copies vs shared handles
+	constexpr std::size_t n = 1'000'000;
+	constexpr std::size_t readers = 16;
+	Sequence<int> snapshot;
+	for (std::size_t i = 0; i < n; i++)
+		snapshot.push_back(int(i));
+	const CowSequence<int> cow(snapshot);
+	const FrozenSequence<int> frozen(snapshot);
+
+	runner.measure("snapshot x16 readers", "deep copy", n * readers, [&] {
+		Sequence<Sequence<int>> handed;
+		for (std::size_t r = 0; r < readers; r++)
+			handed.push_back(snapshot);
+		long long total = 0;
+		for (const auto& copy : handed)
+			total += copy.sum();
+		bench::doNotOptimize(total);
+	});
+	runner.measure("snapshot x16 readers", "CowSequence", n * readers, [&] {
+		Sequence<CowSequence<int>> handed;
+		for (std::size_t r = 0; r < readers; r++)
+			handed.push_back(cow);
+		long long total = 0;
+		for (const auto& copy : handed)
+			total += copy.read().sum();
+		bench::doNotOptimize(total);
+	});
+	runner.measure("snapshot x16 readers", "FrozenSequence", n * readers, [&] {
+		Sequence<FrozenSequence<int>> handed;
+		for (std::size_t r = 0; r < readers; r++)
+			handed.push_back(frozen);
+		long long total = 0;
+		for (const auto& copy : handed)
+			total += copy.read().sum();
+		bench::doNotOptimize(total);
+	});
+}
+
+template <typename Allocator>
+void pageCase(Runner& runner, const std::string& variant, const Allocator& allocator, const Sequence<std::uint32_t>& probes) {
+	constexpr std::size_t n = std::size_t(32) << 20;//256MB of uint64, far past what the TLB covers in 4KB pages
+	if (!wantsAny(runner, { "pages random 256MB", "pages scan 256MB" }, { variant }))
+		return;
+	Sequence<std::uint64_t, Allocator> data(allocator);
+	data.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		data.push_back(i);
+	runner.measure("pages random 256MB", variant, probes.size(), [&] {
+		std::uint64_t total = 0;
+		for (std::uint32_t at : probes)
+			total += data[at];
+		bench::doNotOptimize(total);
+	});
+	runner.measure("pages scan 256MB", variant, n, [&] {
+		bench::doNotOptimize(data.sum());
+	});
+}
+void benchPages(Runner& runner) {//same reads over a block from the heap, from base page mappings and from huge page mappings
+	std::mt19937 rng(3);
+	Sequence<std::uint32_t> probes;
+	if (wantsAny(runner, { "pages random 256MB" }, { "std::allocator", "PageAllocator normal", "PageAllocator huge" })) {
+		for (std::size_t i = 0; i < 4'000'000; i++)
+			probes.push_back(std::uint32_t(rng() % (std::size_t(32) << 20)));
+	}
+	pageCase(runner, "std::allocator", std::allocator<std::uint64_t>(), probes);
+	pageCase(runner, "PageAllocator normal", PageAllocator<std::uint64_t>({ .policy = PagePolicy::normal }), probes);
+	pageCase(runner, "PageAllocator huge", PageAllocator<std::uint64_t>({ .policy = PagePolicy::transparentHuge }), probes);
+}
+
+void benchProfiler(Runner& runner) {//cost of one empty zone, and how close each way of waiting lands on a 2ms frame
+	constexpr std::size_t zones = 10'000;//fits the ring, every rep drains first so nothing is dropped
+	profile::Session session;
+	auto drained = [&] { session.endFrame(); return 0; };
+	runner.measure("empty zone x1e4", "steady_clock pair", zones, [] {
+		for (std::size_t i = 0; i < zones; i++) {
+			const auto begin = std::chrono::steady_clock::now();
+			bench::doNotOptimize(std::chrono::steady_clock::now() - begin);
+		}
+	});
+	runner.measure("empty zone x1e4", "profile::Zone", zones, drained, [](int&) {
+		for (std::size_t i = 0; i < zones; i++) {
+			SEQ_PROFILE_ZONE("empty");
+		}
+	});
+	profile::setEnabled(false);
+	runner.measure("empty zone x1e4", "profile::Zone disabled", zones, drained, [](int&) {
+		for (std::size_t i = 0; i < zones; i++) {
+			SEQ_PROFILE_ZONE("empty");
+		}
+	});
+	profile::setEnabled(true);
+	session.endFrame();
+
+	constexpr std::size_t frames = 20;
+	for (auto [variant, margin] : { std::pair<const char*, std::chrono::microseconds>{ "sleep only", 0 }, { "sleep + spin", std::chrono::microseconds(1500) } }) {
+		double late = 0;//summed over every rep, microseconds past the limit
+		std::size_t paced = 0;
+		auto& result = runner.measure("pace 20 frames 500fps", variant, frames, [&, margin = margin] {
+			FrameTimer timer(500);
+			timer.setSpinMargin(margin);
+			for (std::size_t f = 0; f < frames; f++) {
+				late += std::chrono::duration<double, std::micro>(timer.Pace() - timer.getLimitNanoSec()).count();
+				paced++;
+			}
+		});
+		if (paced)
+			result.counter("late_us", late / double(paced));
+	}
+}
+
+//#################################################
+//usage: sequence [--format=text|csv|json] [--reps=N] [--warmup=N] [--filter=substring] [--out=file]
+int main(int argc, char** argv) {
+#if defined(_MSC_VER) && defined(_DEBUG)
 	_CrtSetReportMode(_CRT_WARN, _CRTDBG_MODE_FILE);
 	_CrtSetReportFile(_CRT_WARN, _CRTDBG_FILE_STDERR);
 	_CrtSetReportMode(_CRT_ERROR, _CRTDBG_MODE_FILE);
 	_CrtSetReportFile(_CRT_ERROR, _CRTDBG_FILE_STDERR);
 	_CrtSetReportMode(_CRT_ASSERT, _CRTDBG_MODE_FILE);
 	_CrtSetReportFile(_CRT_ASSERT, _CRTDBG_FILE_STDERR);
-
-	{
-		Stopwatch clock;
-		Sequence<int> test;
-		for (int i = 0; i < 1000; i++) {
-			test.reserve(test.capacity() + 1);
+#endif
+	bench::Config config;
+	std::string outPath;
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		auto valueOf = [&arg](const char* key) { return arg.substr(std::strlen(key)); };
+		if (arg.rfind("--format=", 0) == 0) {
+			const std::string format = valueOf("--format=");
+			config.format = format == "csv" ? bench::Format::csv : format == "json" ? bench::Format::json : bench::Format::text;
+		}
+		else if (arg.rfind("--reps=", 0) == 0)   config.reps = std::stoul(valueOf("--reps="));
+		else if (arg.rfind("--warmup=", 0) == 0) config.warmup = std::stoul(valueOf("--warmup="));
+		else if (arg.rfind("--filter=", 0) == 0) config.filter = valueOf("--filter=");
+		else if (arg.rfind("--out=", 0) == 0)    outPath = valueOf("--out=");
+		else {
+			std::cerr << "unknown argument " << arg << "\nusage: sequence [--format=text|csv|json] [--reps=N] [--warmup=N] [--filter=substring] [--out=file]\n";
+			return 1;
 		}
-		auto time = clock.MarkMicroSec();
-		std::cout << time.count() << '\n';
+	}
 
-		Sequence<int>int2 = test;
+	{
+		Runner runner(config);
+		coreSuites<int>(runner);
+		coreSuites<double>(runner);
+		coreSuites<std::string>(runner);
+		coreSuites<Blob64>(runner);
+		benchReserveStep(runner);
+		benchArena(runner);
+		benchRelocate(runner);
+		benchSmall(runner);
+		benchStatic(runner);
+		benchGrowth(runner);
+		benchBulk(runner);
+		benchEraseIf(runner);
+		benchParallel(runner);
+		benchSoA(runner);
+		benchConcurrent(runner);
+		benchMapped(runner);
+		benchSerialize(runner);
+		benchChunked(runner);
+		benchSimd(runner);
+		benchFlat(runner);
+		benchSlotMap(runner);
+		benchViews(runner);
+		benchPipeline(runner);
+		benchShared(runner);
+		benchPages(runner);
+		benchProfiler(runner);
 
+		if (outPath.empty()) {
+			runner.report(std::cout);
+		}
+		else {
+			std::ofstream out(outPath);
+			runner.report(out);
+		}
 	}
+#ifdef SEQ_STATS
+	stats::report(std::cerr);//stderr, so csv/json on stdout stays machine readable
+#endif
 
-
+#if defined(_MSC_VER) && defined(_DEBUG)
 	_CrtDumpMemoryLeaks();
+#endif
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,461 @@
+#pragma once
+
+#include "Sequence.h"
+#include <cstddef>
+#include <type_traits>
+
+namespace seq {
+	namespace detail {
+		//trivial types: a plain array. constant evaluation wants every object fully initialized, so only there it gets zeroed
+		template <typename T, std::size_t N, bool Trivial = std::is_trivial_v<T>>
+		struct StaticStorage {
+			constexpr StaticStorage()noexcept {
+				if (std::is_constant_evaluated())
+					std::fill_n(elems, N, T());
+			}
+			T elems[N];
+		};
+		//everything else: a union, so nothing is constructed until construct_at says so. C++20 doesn't let an element of an
+		//inactive union array begin its lifetime during constant evaluation, these only work at run time until C++26
+		template <typename T, std::size_t N>
+		struct StaticStorage<T, N, false> {
+			constexpr StaticStorage()noexcept {}
+			constexpr ~StaticStorage() requires std::is_trivially_destructible_v<T> = default;
+			constexpr ~StaticStorage() {}
+			union { T elems[N]; };
+		};
+	}
+
+	//Sequence with a fixed capacity of N elements stored inline. there is no allocator, nothing ever touches the heap,
+	//running out of room is a std::length_error (push_back, insert...) or a failed try_push_back. trivial T is usable in
+	//constant evaluation, so lookup tables can be built by the compiler:
+	//    constexpr auto squares = [] { StaticSequence<int, 16> s; for (int i = 0; i < 16; i++) s.push_back(i * i); return s; }();
+	template <typename T, std::size_t N>
+	class StaticSequence {
+	private:
+		static_assert(N > 0, "N must be at least 1");
+		static_assert(std::is_object_v<T>, "T must be an object type");
+		static_assert(std::destructible<T>, "T must be destructible");
+		static_assert(!std::is_const_v<T>, "T cannot be const type");
+
+		static constexpr std::size_t first_index = 0;
+	public:
+		//type names
+		using type            = StaticSequence<T, N>;
+		using value_type      = T;
+		using pointer         = T*;
+		using const_pointer   = const T*;
+		using reference       = T&;
+		using const_reference = const T&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator        = typename Sequence<T>::iterator;//same pointer wrappers, so generic code written against Sequence works unchanged
+		using const_iterator  = typename Sequence<T>::const_iterator;
+
+		static constexpr size_type static_capacity = N;
+		//#################################################
+
+	private:
+		//the important shit
+		constexpr void requireRoom(size_type count)const {
+			if (count > N - mSize)
+				throw std::length_error("StaticSequence capacity exceeded");
+		}
+		template <typename Construct>
+		constexpr void tryConstructBack(size_type count, Construct construct) {//construct(p) builds count elements at p and returns their end
+			requireRoom(count);
+			pointer oldEnd = raw_end();
+			pointer newEnd = construct(oldEnd);//the detail:: algorithms clean up after themselves on throw
+			mSize += newEnd - oldEnd;
+		}
+		template <typename Construct>
+		constexpr iterator tryInsert(pointer pos, size_type count, Construct construct) {//built at the back, rotated into place
+			const size_type index = pos - raw_begin();
+			const size_type oldSize = mSize;
+			tryConstructBack(count, construct);
+			std::rotate(raw_begin() + index, raw_begin() + oldSize, raw_end());
+			return { raw_begin() + index };
+		}
+		constexpr void validatePosition(const_pointer pos)const {
+			if (pos < raw_begin() || pos > raw_end()) throw std::out_of_range("position out of range");
+		}
+		//#################################################
+
+		//the convenience
+		constexpr void objDestroyAll()noexcept {
+			std::destroy(raw_begin(), raw_end());
+			mSize = 0;
+		}
+		template <typename Source>
+		constexpr void assignFrom(Source&& rhs) {//elementwise, what both hold is assigned, the rest constructed or destroyed
+			using Elem = std::conditional_t<std::is_lvalue_reference_v<Source>, const_reference, value_type&&>;
+			const size_type common = std::min(mSize, rhs.mSize);
+			for (size_type i = 0; i < common; i++)
+				raw_begin()[i] = static_cast<Elem>(rhs.raw_begin()[i]);
+			if (rhs.mSize > mSize) {
+				auto from = rhs.raw_begin() + common;
+				auto to = rhs.raw_end();
+				if constexpr (std::is_lvalue_reference_v<Source>)
+					mSize = detail::uninitialized_copy(from, to, raw_end()) - raw_begin();
+				else
+					mSize = detail::uninitialized_move(from, to, raw_end()) - raw_begin();
+			}
+			else {
+				resize_shrink(common);
+			}
+		}
+		constexpr pointer       raw_begin()noexcept         { return storage.elems; }
+		constexpr pointer       raw_end()noexcept           { return storage.elems + mSize; }
+		constexpr const_pointer raw_begin()const noexcept   { return storage.elems; }
+		constexpr const_pointer raw_end()const noexcept     { return storage.elems + mSize; }
+		//#################################################
+	public:
+		//CONSTRUCTORS
+		constexpr StaticSequence()noexcept = default;
+		constexpr explicit StaticSequence(size_type count) requires std::default_initializable<value_type> {
+			resize_grow(count);
+		}
+		constexpr StaticSequence(size_type count, const_reference value) requires std::copyable<value_type> {
+			tryConstructBack(count, [&value, count](pointer p) {
+				return detail::uninitialized_fill_n(p, count, value);
+				}
+			);
+		}
+		constexpr StaticSequence(std::initializer_list<value_type> init) requires std::copyable<value_type> {
+			append_range(init);
+		}
+		//trivial T copies and moves the whole block like a std::array would, the type stays trivially copyable.
+		//a moved from StaticSequence of anything else is left empty
+		constexpr StaticSequence(const StaticSequence&) requires std::is_trivial_v<value_type> = default;
+		constexpr StaticSequence(const StaticSequence& rhs) requires (!std::is_trivial_v<value_type>) && std::copyable<value_type> {
+			mSize = detail::uninitialized_copy(rhs.raw_begin(), rhs.raw_end(), raw_begin()) - raw_begin();
+		}
+		constexpr StaticSequence(StaticSequence&&) requires std::is_trivial_v<value_type> = default;
+		constexpr StaticSequence(StaticSequence&& rhs)noexcept requires (!std::is_trivial_v<value_type>) && strong_movable<value_type> {
+			mSize = detail::uninitialized_move(rhs.raw_begin(), rhs.raw_end(), raw_begin()) - raw_begin();
+			rhs.objDestroyAll();
+		}
+		constexpr StaticSequence& operator=(const StaticSequence&) requires std::is_trivial_v<value_type> = default;
+		constexpr StaticSequence& operator=(const StaticSequence& rhs) requires (!std::is_trivial_v<value_type>) && std::copyable<value_type> {
+			if (this != &rhs)
+				assignFrom(rhs);
+			return *this;
+		}
+		constexpr StaticSequence& operator=(StaticSequence&&) requires std::is_trivial_v<value_type> = default;
+		constexpr StaticSequence& operator=(StaticSequence&& rhs)noexcept requires (!std::is_trivial_v<value_type>) && strong_movable<value_type> {
+			if (this != &rhs) {
+				assignFrom(std::move(rhs));
+				rhs.objDestroyAll();
+			}
+			return *this;
+		}
+		constexpr StaticSequence& operator=(std::initializer_list<value_type> ilist) requires std::copyable<value_type> {
+			if (ilist.size() > N)
+				throw std::length_error("StaticSequence capacity exceeded");
+			clear();
+			append_range(ilist);
+			return *this;
+		}
+		constexpr ~StaticSequence() requires std::is_trivially_destructible_v<value_type> = default;
+		constexpr ~StaticSequence()noexcept {
+			objDestroyAll();
+		}
+		//#################################################
+
+		//ACCESS
+		constexpr reference front() {
+			assert(mSize > first_index);
+			return raw_begin()[first_index];
+		}
+		constexpr const_reference front()const {
+			assert(mSize > first_index);
+			return raw_begin()[first_index];
+		}
+		constexpr reference back() {
+			assert(mSize > first_index);
+			return raw_begin()[mSize - 1];
+		}
+		constexpr const_reference back()const {
+			assert(mSize > first_index);
+			return raw_begin()[mSize - 1];
+		}
+		constexpr reference operator[](size_type index) {
+			assert(index < mSize);
+			return raw_begin()[index];
+		}
+		constexpr const_reference operator[](size_type index)const {
+			assert(index < mSize);
+			return raw_begin()[index];
+		}
+		constexpr reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return raw_begin()[pos];
+		}
+		constexpr const_reference at(size_type pos)const {
+			if (pos >= size())
+				throw std::out_of_range("position out of range");
+			return raw_begin()[pos];
+		}
+		constexpr pointer        data()noexcept           { return raw_begin(); }
+		constexpr const_pointer  data()const noexcept     { return raw_begin(); }
+
+		constexpr iterator       begin()                  { return { raw_begin() }; }
+		constexpr iterator       end()                    { return { raw_end() }; }
+		constexpr const_iterator begin()const             { return { raw_begin() }; }
+		constexpr const_iterator end()const               { return { raw_end() }; }
+		constexpr const_iterator cbegin()const            { return { raw_begin() }; }
+		constexpr const_iterator cend()const              { return { raw_end() }; }
+
+		constexpr SequenceView<value_type>       view()noexcept        { return { raw_begin(), mSize }; }
+		constexpr SequenceView<const value_type> view()const noexcept  { return { raw_begin(), mSize }; }
+		constexpr SequenceView<value_type> slice(size_type offset, size_type count = SequenceView<value_type>::npos) {
+			return view().slice(offset, count);
+		}
+		constexpr SequenceView<const value_type> slice(size_type offset, size_type count = SequenceView<value_type>::npos)const {
+			return view().slice(offset, count);
+		}
+		//#################################################
+
+		//SEARCH, same dispatch as Sequence
+		constexpr iterator find(const_reference value) requires std::equality_comparable<value_type> {
+			return { raw_begin() + (std::as_const(*this).find(value) - cbegin()) };
+		}
+		constexpr const_iterator find(const_reference value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>) {
+				if (!std::is_constant_evaluated())
+					return { simd::find(raw_begin(), raw_end(), value) };
+			}
+			return { std::find(raw_begin(), raw_end(), value) };
+		}
+		constexpr size_type count(const_reference value)const requires std::equality_comparable<value_type> {
+			if constexpr (std::is_arithmetic_v<value_type>) {
+				if (!std::is_constant_evaluated())
+					return simd::count(raw_begin(), raw_end(), value);
+			}
+			return size_type(std::count(raw_begin(), raw_end(), value));
+		}
+		constexpr bool contains(const_reference value)const requires std::equality_comparable<value_type> {
+			return find(value) != cend();
+		}
+		//#################################################
+
+		//MODIFICATION
+		template <typename U>
+		constexpr void push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {//implicit copy or move requirement
+			requireRoom(1);
+			std::construct_at(raw_end(), std::forward<U>(value));
+			++mSize;
+		}
+		template<typename... Args> constexpr reference emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			requireRoom(1);
+			pointer elem = raw_end();
+			std::construct_at(elem, std::forward<Args>(args)...);//safe to throw on fail, size not touched yet
+			++mSize;
+			return *elem;
+		}
+		//the non throwing forms for paths that must not unwind: nullptr when full, the argument is left alone then
+		template <typename U>
+		constexpr pointer try_push_back(U&& value) requires std::convertible_to<U, value_type>&& std::constructible_from<value_type, U&&> {
+			return try_emplace_back(std::forward<U>(value));
+		}
+		template<typename... Args> constexpr pointer try_emplace_back(Args&&... args) requires std::constructible_from<value_type, Args&&...> {
+			if (mSize == N)
+				return nullptr;
+			pointer elem = raw_end();
+			std::construct_at(elem, std::forward<Args>(args)...);
+			++mSize;
+			return elem;
+		}
+		template <std::ranges::input_range Range>
+		constexpr void append_range(Range&& range) requires std::constructible_from<value_type, std::ranges::range_reference_t<Range>> {
+			if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+				const size_type count = static_cast<size_type>(std::ranges::distance(range));
+				tryConstructBack(count, [&range](pointer p) {
+					return detail::uninitialized_copy(std::ranges::begin(range), std::ranges::end(range), p);
+					}
+				);
+			}
+			else {//single pass, size unknown up front
+				for (auto&& elem : range)
+					emplace_back(std::forward<decltype(elem)>(elem));
+			}
+		}
+		template <typename... Args>
+		constexpr iterator emplace(const_iterator pos, Args&&... args) requires std::constructible_from<value_type, Args&&...> && strong_movable<value_type> {
+			validatePosition(pos.base());
+			return tryInsert(raw_begin() + (pos.base() - raw_begin()), 1, [&args...](pointer p) {
+				std::construct_at(p, std::forward<Args>(args)...);
+				return p + 1;
+				}
+			);
+		}
+		constexpr iterator insert(const_iterator pos, const_reference value) requires std::copyable<value_type> && strong_movable<value_type> {
+			return emplace(pos, value);
+		}
+		constexpr iterator insert(const_iterator pos, value_type&& value) requires strong_movable<value_type> {
+			return emplace(pos, std::move(value));
+		}
+		constexpr iterator insert(const_iterator pos, size_type count, const_reference value) requires std::copyable<value_type> && strong_movable<value_type> {
+			validatePosition(pos.base());
+			return tryInsert(raw_begin() + (pos.base() - raw_begin()), count, [&value, count](pointer p) {
+				return detail::uninitialized_fill_n(p, count, value);
+				}
+			);
+		}
+		template <std::forward_iterator It, std::sentinel_for<It> S>
+		constexpr iterator insert(const_iterator pos, It first, S last) requires std::constructible_from<value_type, std::iter_reference_t<It>> && strong_movable<value_type> {
+			validatePosition(pos.base());
+			const size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+			return tryInsert(raw_begin() + (pos.base() - raw_begin()), count, [&first, &last](pointer p) {
+				return detail::uninitialized_copy(first, last, p);
+				}
+			);
+		}
+		constexpr iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) requires std::copyable<value_type> && strong_movable<value_type> {
+			return insert(pos, ilist.begin(), ilist.end());
+		}
+		constexpr void pop_back()noexcept {
+			if (mSize > 0) {
+				std::destroy_at(raw_end() - 1);
+				--mSize;
+			}
+		}
+		constexpr iterator erase(iterator pos)requires strong_movable<value_type> {
+			pointer eraseElem = pos.base();
+			pointer arrayEnd = raw_end();
+			validatePosition(eraseElem);
+			if (eraseElem == arrayEnd) return arrayEnd;
+
+			std::move(eraseElem + 1, arrayEnd, eraseElem);
+			std::destroy_at(arrayEnd - 1);
+			--mSize;
+			return eraseElem;
+		}
+		constexpr iterator erase(iterator first, iterator last)requires strong_movable<value_type> {
+			pointer eraseFirst = first.base();
+			pointer eraseLast = last.base();
+			pointer arrayEnd = raw_end();
+
+			validatePosition(eraseFirst);
+			validatePosition(eraseLast);
+			if (eraseLast < eraseFirst) throw std::out_of_range("position out of range");
+			if (eraseFirst == eraseLast || eraseFirst == arrayEnd) return arrayEnd;
+
+			pointer destroyBegin = std::move(eraseLast, arrayEnd, eraseFirst);
+			std::destroy(destroyBegin, arrayEnd);
+			mSize = destroyBegin - raw_begin();
+			return eraseFirst;
+		}
+		constexpr iterator remove(iterator pos)requires strong_movable<value_type> {//unordered, the last element fills the hole
+			pointer removeElem = pos.base();
+			pointer arrayEnd = raw_end();
+			validatePosition(removeElem);
+			if (removeElem == arrayEnd) return arrayEnd;
+
+			--arrayEnd;
+			*removeElem = std::move(*arrayEnd);
+			std::destroy_at(arrayEnd);
+			--mSize;
+			return removeElem;
+		}
+		template <typename UnaryPred>
+		constexpr iterator remove(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred, const_reference> {
+			pointer current = raw_begin();
+			pointer validEnd = raw_end();
+
+			while (current < validEnd) {
+				if (predicate(*current)) {
+					--validEnd;
+					if (current != validEnd)
+						*current = std::move(*validEnd);
+				}
+				else {
+					++current;
+				}
+			}
+
+			std::destroy(validEnd, raw_end());
+			mSize = validEnd - raw_begin();
+			return validEnd;
+		}
+		template <typename UnaryPred>
+		constexpr size_type erase_if(UnaryPred predicate) requires strong_movable<value_type> && std::predicate<UnaryPred&, const_reference> {//ordered
+			pointer newEnd = std::remove_if(raw_begin(), raw_end(), predicate);
+			const size_type erased = raw_end() - newEnd;
+			resize_shrink(mSize - erased);
+			return erased;
+		}
+		constexpr void swap(StaticSequence& rhs) requires strong_movable<value_type> {//no pointers to trade, the elements walk over
+			StaticSequence& longer = mSize >= rhs.mSize ? *this : rhs;
+			StaticSequence& shorter = mSize >= rhs.mSize ? rhs : *this;
+			const size_type common = shorter.mSize;
+			std::swap_ranges(longer.raw_begin(), longer.raw_begin() + common, shorter.raw_begin());
+			shorter.mSize = detail::uninitialized_move(longer.raw_begin() + common, longer.raw_end(), shorter.raw_end()) - shorter.raw_begin();
+			longer.resize_shrink(common);
+		}
+		//#################################################
+
+		//CAPACITY
+		constexpr bool      isEmpty()const noexcept  { return mSize == 0; }
+		constexpr bool      isFull()const noexcept   { return mSize == N; }
+		constexpr bool      isValid()const noexcept  { return true; }//the storage is always there, kept for parity with Sequence
+		constexpr size_type size()const noexcept     { return mSize; }
+		static constexpr size_type capacity()noexcept { return N; }
+
+		constexpr void resize_shrink(size_type count)noexcept {
+			if (count >= mSize) return;
+
+			std::destroy(raw_begin() + count, raw_end());
+			mSize = count;
+		}
+		constexpr void resize_grow(size_type count)requires std::default_initializable<value_type> {
+			if (count <= mSize) return;
+
+			const size_type amount = count - mSize;
+			tryConstructBack(amount, [amount](pointer p) {
+				return detail::uninitialized_value_construct_n(p, amount);
+				}
+			);
+		}
+		constexpr void clear() noexcept {
+			objDestroyAll();
+		}
+		//#################################################
+	private:
+		//members
+		detail::StaticStorage<T, N> storage;
+		size_type mSize = 0;
+	};
+
+	template <typename T, std::size_t N>
+	constexpr bool operator==(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return lhs.view() == rhs.view();
+	}
+	template <typename T, std::size_t N>
+	constexpr bool operator!=(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return !(lhs == rhs);
+	}
+	template <typename T, std::size_t N>
+	constexpr bool operator<(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	template <typename T, std::size_t N>
+	constexpr bool operator>(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return rhs < lhs;
+	}
+	template <typename T, std::size_t N>
+	constexpr bool operator<=(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return !(rhs < lhs);
+	}
+	template <typename T, std::size_t N>
+	constexpr bool operator>=(const StaticSequence<T, N>& lhs, const StaticSequence<T, N>& rhs) {
+		return !(lhs < rhs);
+	}
+
+	template <typename T, std::size_t N>
+	constexpr void swap(StaticSequence<T, N>& lhs, StaticSequence<T, N>& rhs) {
+		lhs.swap(rhs);
+	}
+}
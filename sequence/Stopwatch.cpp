@@ -1,8 +1,12 @@
 #include "Stopwatch.h"
-std::chrono::duration<float> Stopwatch::Mark() {
+#include <thread>
+std::chrono::steady_clock::duration Stopwatch::MarkTicks() {
 	const auto old = last;
 	last = std::chrono::steady_clock::now();
-	const std::chrono::duration<float> frametime = last - old;
+	return last - old;
+}
+std::chrono::duration<float> Stopwatch::Mark() {
+	const std::chrono::duration<float> frametime = MarkTicks();
 	return frametime;
 }
 Stopwatch::Stopwatch() {
@@ -21,6 +25,26 @@ std::chrono::microseconds Stopwatch::MarkMicroSec() {
 	auto time = Mark();
 	return std::chrono::duration_cast<std::chrono::microseconds>(time);
 }
+std::chrono::nanoseconds Stopwatch::MarkNanoSec() {
+	auto time = MarkTicks();//straight from the clock, a float round trip would eat the low digits
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time);
+}
+
+std::chrono::duration<float> FrameTimer::Pace() {
+	using clock = std::chrono::steady_clock;
+	const auto frameStart = last;
+	const auto deadline = frameStart + getLimitNanoSec();
+	auto now = clock::now();
+	const bool early = now < deadline;
+	while (deadline - now > spinMargin) {
+		std::this_thread::sleep_for(deadline - now - spinMargin);
+		now = clock::now();
+	}
+	while (now < deadline)
+		now = clock::now();
+	last = early ? deadline : now;
+	return now - frameStart;
+}
 
 uint32_t FrameTimer::getFPS()const
 {
@@ -29,7 +53,7 @@ uint32_t FrameTimer::getFPS()const
 void FrameTimer::setFPS(uint32_t FPS)
 {
 	fps = FPS;
-	limit = std::chrono::duration<float>(ONE_SECOND / fps);
+	limit = std::chrono::duration<float>(fps ? ONE_SECOND / fps : 0.0f);
 }
 float FrameTimer::getLimitFloat()const {
 	return limit.count();
@@ -39,4 +63,13 @@ std::chrono::milliseconds FrameTimer::getLimitMilliSec()const {
 }
 std::chrono::microseconds FrameTimer::getLimitMicroSec()const {
 	return std::chrono::duration_cast<std::chrono::microseconds>(limit);
+}
+std::chrono::nanoseconds FrameTimer::getLimitNanoSec()const {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(limit);
+}
+std::chrono::microseconds FrameTimer::getSpinMargin()const {
+	return spinMargin;
+}
+void FrameTimer::setSpinMargin(std::chrono::microseconds margin) {
+	spinMargin = margin;
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 #include <chrono>
 class Stopwatch {
+protected:
 	std::chrono::steady_clock::time_point last;
 
+	std::chrono::steady_clock::duration MarkTicks();
 	std::chrono::duration<float> Mark();
 
 public:
@@ -11,21 +13,34 @@ public:
 	float MarkFloat();
 	std::chrono::milliseconds MarkMilliSec();
 	std::chrono::microseconds MarkMicroSec();
+	std::chrono::nanoseconds MarkNanoSec();
 };
 
+//fps 0 is unlimited, Pace() then only marks
 class FrameTimer : public Stopwatch {
 	static constexpr float ONE_SECOND = 1.0f;
 	static constexpr uint32_t defaultFPS = 60;
+	static constexpr std::chrono::microseconds defaultSpinMargin{ 1500 };//covers a sleep overshooting by a scheduler tick
 
 	std::chrono::duration<float> limit;
 	uint32_t fps = 0;
+	std::chrono::microseconds spinMargin = defaultSpinMargin;
 
 public:
-	FrameTimer(uint32_t fps = defaultFPS) :fps(fps), limit(ONE_SECOND / fps) {}
+	FrameTimer(uint32_t fps = defaultFPS) :limit(fps ? ONE_SECOND / fps : 0.0f), fps(fps) {}
+
+	//waits until getLimit has passed since the last Pace (or construction), then marks. the wait sleeps while more than the
+	//spin margin is left and spins the rest, sleeping alone is off by a scheduler tick. a frame that finished early restarts
+	//exactly on its deadline so the cadence doesn't drift, one that overran restarts now instead of trying to catch up.
+	//returns the whole frame, work plus wait
+	std::chrono::duration<float> Pace();
 
 	uint32_t getFPS()const;
 	void setFPS(uint32_t FPS);
 	float getLimitFloat()const;
 	std::chrono::milliseconds getLimitMilliSec()const;
 	std::chrono::microseconds getLimitMicroSec()const;
+	std::chrono::nanoseconds getLimitNanoSec()const;
+	std::chrono::microseconds getSpinMargin()const;
+	void setSpinMargin(std::chrono::microseconds margin);//0 sleeps all the way, a whole frame spins all the way
 };
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "ThreadPool.h"
+#include <utility>
+
+namespace seq {
+	namespace {
+		thread_local const ThreadPool* currentPool = nullptr;
+		thread_local std::size_t currentIndex = 0;
+	}
+
+	ThreadPool::ThreadPool(std::size_t threads) {
+		const std::size_t background = threads > 1 ? threads - 1 : 0;
+		for (std::size_t i = 0; i < background + 1; i++)
+			queues.push_back(std::make_unique<Queue>());
+		for (std::size_t i = 0; i < background; i++)
+			workers.emplace_back([this, i] { workerLoop(i); });
+	}
+
+	ThreadPool::~ThreadPool()noexcept {
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	void ThreadPool::submit(std::function<void()> task) {
+		//workers feed their own deque, everyone else spreads round robin
+		const std::size_t index = (currentPool == this) ? currentIndex : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+		{
+			std::lock_guard<std::mutex> guard(queues[index]->lock);
+			queues[index]->tasks.push_back(std::move(task));
+		}
+		pending.fetch_add(1, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);//pairs with the predicate check in workerLoop, no lost wakeups
+		}
+		wake.notify_one();
+	}
+
+	bool ThreadPool::tryRunOne() {
+		std::function<void()> task;
+		const bool found = (currentPool == this) ? (popLocal(currentIndex, task) || steal(currentIndex, task)) : steal(queues.size(), task);
+		if (!found)
+			return false;
+		task();
+		return true;
+	}
+
+	std::size_t ThreadPool::size()const noexcept {
+		return workers.size() + 1;
+	}
+
+	ThreadPool& ThreadPool::global() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::workerLoop(std::size_t index) {
+		currentPool = this;
+		currentIndex = index;
+
+		std::function<void()> task;
+		while (true) {
+			if (popLocal(index, task) || steal(index, task)) {
+				task();
+				task = nullptr;
+				continue;
+			}
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+			if (stopping && pending.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	bool ThreadPool::popLocal(std::size_t index, std::function<void()>& task) {
+		Queue& queue = *queues[index];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.tasks.empty())
+			return false;
+		task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		pending.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool ThreadPool::steal(std::size_t thief, std::function<void()>& task) {
+		const std::size_t count = queues.size();
+		for (std::size_t offset = 1; offset <= count; offset++) {
+			Queue& victim = *queues[(thief + offset) % count];
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (victim.tasks.empty())
+				continue;
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			pending.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	TaskGroup::TaskGroup(ThreadPool& pool)noexcept :pool(pool) {}
+
+	TaskGroup::~TaskGroup()noexcept {
+		//never leave tasks running that point at a dead group
+		while (outstanding.load(std::memory_order_acquire) > 0) {
+			if (!pool.tryRunOne())
+				std::this_thread::yield();
+		}
+	}
+
+	void TaskGroup::run(std::function<void()> task) {
+		outstanding.fetch_add(1, std::memory_order_relaxed);
+		try {
+			pool.submit([this, task = std::move(task)] {
+				try {
+					task();
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> guard(errorLock);
+					if (!error)
+						error = std::current_exception();
+				}
+				outstanding.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		catch (...) {//never queued, wait() and the destructor mustn't wait for it
+			outstanding.fetch_sub(1, std::memory_order_release);
+			throw;
+		}
+	}
+
+	void TaskGroup::wait() {
+		while (outstanding.load(std::memory_order_acquire) > 0) {
+			if (!pool.tryRunOne())
+				std::this_thread::yield();
+		}
+		if (error)
+			std::rethrow_exception(std::exchange(error, nullptr));
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace seq {
+	//work stealing pool. every worker owns a deque: it pushes and pops at the back (hot, cache friendly),
+	//idle workers steal from the front of the others. a thread waiting on a TaskGroup runs tasks too,
+	//so a pool of n threads keeps n - 1 in the background and the caller is the nth
+	class ThreadPool {
+	public:
+		explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool()noexcept;
+
+		void submit(std::function<void()> task);
+		bool tryRunOne();//runs one queued task on the calling thread, false if there was nothing to do
+
+		std::size_t size()const noexcept;//including the calling thread
+
+		static ThreadPool& global();
+
+	private:
+		struct Queue {
+			std::mutex lock;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		void workerLoop(std::size_t index);
+		bool popLocal(std::size_t index, std::function<void()>& task);
+		bool steal(std::size_t thief, std::function<void()>& task);
+
+		std::vector<std::unique_ptr<Queue>> queues;//one per worker plus one shared for outside submitters
+		std::vector<std::thread> workers;
+		std::atomic<std::size_t> pending = 0;
+		std::atomic<std::size_t> nextQueue = 0;
+		std::atomic<bool> stopping = false;
+		std::mutex sleepLock;
+		std::condition_variable wake;
+	};
+
+	//fork/join scope on a pool. wait() helps run tasks instead of blocking, so groups can nest (parallel sort does).
+	//the first exception thrown by a task is rethrown from wait()
+	class TaskGroup {
+	public:
+		explicit TaskGroup(ThreadPool& pool)noexcept;
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+		~TaskGroup()noexcept;
+
+		void run(std::function<void()> task);
+		void wait();
+
+	private:
+		ThreadPool& pool;
+		std::atomic<std::size_t> outstanding = 0;
+		std::mutex errorLock;
+		std::exception_ptr error;
+	};
+}